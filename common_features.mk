@@ -30,6 +30,11 @@ else ifeq ($(strip $(DEBUG_MATRIX_SCAN_RATE_ENABLE)), api)
     OPT_DEFS += -DDEBUG_MATRIX_SCAN_RATE
 endif
 
+ifeq ($(strip $(SCAN_PROFILE_ENABLE)), yes)
+    OPT_DEFS += -DSCAN_PROFILE_ENABLE
+    SRC += $(QUANTUM_DIR)/scan_profile.c
+endif
+
 ifeq ($(strip $(API_SYSEX_ENABLE)), yes)
     OPT_DEFS += -DAPI_SYSEX_ENABLE
     OPT_DEFS += -DAPI_ENABLE
@@ -499,6 +504,12 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
         else
             QUANTUM_SRC += $(QUANTUM_DIR)/matrix.c
         endif
+
+        ifeq ($(strip $(MATRIX_WAKE_ENABLE)), yes)
+            OPT_DEFS += -DMATRIX_WAKE_ENABLE
+            COMMON_VPATH += $(QUANTUM_DIR)/matrix_wake
+            QUANTUM_SRC += $(QUANTUM_DIR)/matrix_wake/matrix_wake.c
+        endif
     endif
 endif
 
@@ -530,6 +541,9 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
     # Determine which (if any) transport files are required
     ifneq ($(strip $(SPLIT_TRANSPORT)), custom)
         QUANTUM_LIB_SRC += $(QUANTUM_DIR)/split_common/transport.c
+        QUANTUM_LIB_SRC += $(QUANTUM_DIR)/split_common/transactions.c
+        QUANTUM_LIB_SRC += $(QUANTUM_DIR)/split_common/split_link.c
+        QUANTUM_LIB_SRC += $(QUANTUM_DIR)/split_common/split_key_events.c
         # Functions added via QUANTUM_LIB_SRC are only included in the final binary if they're called.
         # Unused functions are pruned away, which is why we can add multiple drivers here without bloat.
         ifeq ($(PLATFORM),AVR)
@@ -134,6 +134,10 @@
 #    define EVEN_PARITY 0
 #    define PARITY EVEN_PARITY
 
+#    if defined(SERIAL_DELAY) && defined(SOFT_SERIAL_ADAPTIVE_SPEED)
+#        error SOFT_SERIAL_ADAPTIVE_SPEED only works with the standard SELECT_SOFT_SERIAL_SPEED setups
+#    endif
+
 #    ifdef SERIAL_DELAY
 // custom setup in config.h
 // #define TID_SEND_ADJUST 2
@@ -234,6 +238,46 @@
 static SSTD_t *Transaction_table      = NULL;
 static uint8_t Transaction_table_size = 0;
 
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+// The pulse periods of the standard setups, picked at runtime. The cycle
+// adjustments stay those of SELECT_SOFT_SERIAL_SPEED, they differ by a few
+// cycles at most.
+#        include <util/delay_basic.h>
+// _delay_loop_2() takes 4 cycles per loop
+#        define SERIAL_DELAY_LOOPS(us) ((uint16_t)((F_CPU / 1000000UL) * (us) / 4))
+
+static const uint8_t serial_delays[SOFT_SERIAL_SPEED_COUNT] = {4, 6, 12, 24, 36, 48};
+static uint8_t       serial_speed                           = SELECT_SOFT_SERIAL_SPEED;
+static uint16_t      serial_delay_loops                     = SERIAL_DELAY_LOOPS(SERIAL_DELAY);
+static uint16_t      serial_delay_half1_loops               = SERIAL_DELAY_LOOPS(SERIAL_DELAY_HALF1);
+static uint16_t      serial_delay_half2_loops               = SERIAL_DELAY_LOOPS(SERIAL_DELAY_HALF2);
+
+void soft_serial_set_speed(uint8_t speed) {
+    if (speed >= SOFT_SERIAL_SPEED_COUNT) return;
+    uint8_t delay = serial_delays[speed];
+    cli();
+    serial_speed             = speed;
+    serial_delay_loops       = SERIAL_DELAY_LOOPS(delay);
+    serial_delay_half1_loops = SERIAL_DELAY_LOOPS(delay / 2);
+    serial_delay_half2_loops = SERIAL_DELAY_LOOPS(delay - delay / 2);
+    sei();
+}
+
+uint8_t soft_serial_get_speed(void) { return serial_speed; }
+
+#        define SYNC_RECV_LIMIT (serial_delays[serial_speed] * 5)
+
+inline static void serial_delay(void) ALWAYS_INLINE;
+inline static void serial_delay(void) { _delay_loop_2(serial_delay_loops); }
+
+inline static void serial_delay_half1(void) ALWAYS_INLINE;
+inline static void serial_delay_half1(void) { _delay_loop_2(serial_delay_half1_loops); }
+
+inline static void serial_delay_half2(void) ALWAYS_INLINE;
+inline static void serial_delay_half2(void) { _delay_loop_2(serial_delay_half2_loops); }
+#    else
+#        define SYNC_RECV_LIMIT (SERIAL_DELAY * 5)
+
 inline static void serial_delay(void) ALWAYS_INLINE;
 inline static void serial_delay(void) { _delay_us(SERIAL_DELAY); }
 
@@ -242,6 +286,7 @@ inline static void serial_delay_half1(void) { _delay_us(SERIAL_DELAY_HALF1); }
 
 inline static void serial_delay_half2(void) ALWAYS_INLINE;
 inline static void serial_delay_half2(void) { _delay_us(SERIAL_DELAY_HALF2); }
+#    endif
 
 inline static void serial_output(void) ALWAYS_INLINE;
 inline static void serial_output(void) { setPinOutput(SOFT_SERIAL_PIN); }
@@ -279,7 +324,7 @@ void soft_serial_target_init(SSTD_t *sstd_table, int sstd_table_size) {
 // Used by the sender to synchronize timing with the reciver.
 static void sync_recv(void) NO_INLINE;
 static void sync_recv(void) {
-    for (uint8_t i = 0; i < SERIAL_DELAY * 5 && serial_read_pin(); i++) {
+    for (uint8_t i = 0; i < SYNC_RECV_LIMIT && serial_read_pin(); i++) {
     }
     // This shouldn't hang if the target disconnects because the
     // serial line will float to high if the target does disconnect.
@@ -466,7 +511,11 @@ int soft_serial_transaction(int sstd_index) {
 #    ifndef SERIAL_USE_MULTI_TRANSACTION
     // wait for the target response
     serial_input_with_pullup();
+#        ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    serial_delay();
+#        else
     _delay_us(SLAVE_INT_RESPONSE_TIME);
+#        endif
 
     // check if the target is present
     if (serial_read_pin()) {
@@ -50,8 +50,28 @@
 #    error invalid SELECT_SOFT_SERIAL_SPEED value
 #endif
 
+#ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+// Same pulse periods as above, picked at runtime
+static const uint8_t serial_delays[SOFT_SERIAL_SPEED_COUNT] = {12, 16, 24, 32, 48, 64};
+static uint8_t       serial_speed                           = SELECT_SOFT_SERIAL_SPEED;
+static rtcnt_t       serial_delay_ticks                     = US2RTC(STM32_SYSCLK, SERIAL_DELAY);
+static rtcnt_t       serial_delay_half_ticks                = US2RTC(STM32_SYSCLK, SERIAL_DELAY / 2);
+
+void soft_serial_set_speed(uint8_t speed) {
+    if (speed >= SOFT_SERIAL_SPEED_COUNT) return;
+    serial_speed            = speed;
+    serial_delay_ticks      = US2RTC(STM32_SYSCLK, serial_delays[speed]);
+    serial_delay_half_ticks = US2RTC(STM32_SYSCLK, serial_delays[speed] / 2);
+}
+
+uint8_t soft_serial_get_speed(void) { return serial_speed; }
+
+inline static void serial_delay(void) { chSysPolledDelayX(serial_delay_ticks); }
+inline static void serial_delay_half(void) { chSysPolledDelayX(serial_delay_half_ticks); }
+#else
 inline static void serial_delay(void) { wait_us(SERIAL_DELAY); }
 inline static void serial_delay_half(void) { wait_us(SERIAL_DELAY / 2); }
+#endif
 inline static void serial_delay_blip(void) { wait_us(1); }
 inline static void serial_output(void) { setPinOutput(SOFT_SERIAL_PIN); }
 inline static void serial_input(void) { setPinInputHigh(SOFT_SERIAL_PIN); }
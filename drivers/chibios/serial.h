@@ -60,3 +60,20 @@ int soft_serial_transaction(int sstd_index);
 #ifdef SERIAL_USE_MULTI_TRANSACTION
 int soft_serial_get_and_clean_status(int sstd_index);
 #endif
+
+#ifdef SERIAL_USART_PIPELINE
+// largest payload of any transaction, the split transport checks its own at compile time
+#    ifndef SERIAL_USART_PIPELINE_BUFFER_SIZE
+#        define SERIAL_USART_PIPELINE_BUFFER_SIZE 32
+#    endif
+#endif
+
+#ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+// runtime speed, same scale as SELECT_SOFT_SERIAL_SPEED (0: fastest)
+#    ifndef SELECT_SOFT_SERIAL_SPEED
+#        define SELECT_SOFT_SERIAL_SPEED 1
+#    endif
+#    define SOFT_SERIAL_SPEED_COUNT 6
+void    soft_serial_set_speed(uint8_t speed);
+uint8_t soft_serial_get_speed(void);
+#endif
@@ -17,6 +17,7 @@
 #include "serial_usart.h"
 
 #include <stdatomic.h>
+#include <string.h>
 
 #if !defined(USE_GPIOV1)
 // The default PAL alternate modes are used to signal that the pins are used for USART
@@ -41,9 +42,12 @@
 #endif
 
 #define SIGNAL_HANDSHAKE_RECEIVED 0x1
+#define SIGNAL_PAYLOAD_RECEIVED 0x2
 
 void        handle_transactions_slave(uint8_t sstd_index);
+#if !defined(SERIAL_USART_PIPELINE)
 static void receive_transaction_handshake(UARTDriver* uartp, uint16_t received_handshake);
+#endif
 
 /*
  * UART driver configuration structure. We use the blocking DMA enabled API and
@@ -69,6 +73,7 @@ static uint8_t              Transaction_table_size = 0;
 static atomic_uint_least8_t handshake              = 0xFF;
 static thread_reference_t   tp_target              = NULL;
 
+#if !defined(SERIAL_USART_PIPELINE)
 /*
  * This callback is invoked when a character is received but the application
  * was not ready to receive it, the character is passed as parameter.
@@ -89,6 +94,195 @@ static void receive_transaction_handshake(UARTDriver* uartp, uint16_t received_h
     chEvtSignalI(tp_target, (eventmask_t)SIGNAL_HANDSHAKE_RECEIVED);
     chSysUnlockFromISR();
 }
+#endif
+
+#if defined(SERIAL_USART_PIPELINE)
+/*
+ * Pipelined mode. A transaction is a single frame each way, a header byte
+ * followed by the payload, without the handshake round trip:
+ *
+ *   master: [sequence << 4 | index] [initiator2target buffer]
+ *   slave:  [header ^ HANDSHAKE_MAGIC] [target2initiator buffer]
+ *
+ * Only a pure read, a transaction without an initiator2target buffer, is sent
+ * ahead: the slave does nothing with it but answer, so a frame that is never
+ * collected does no harm. Once the same pure read was called twice in a row,
+ * ignoring the other transactions in between, the master sends its next frame
+ * at the end of each call and returns the response of the previous one, so it
+ * never waits for the slave while that read repeats every scan; the data it
+ * returns is one frame old, a scan of added latency. Every other call, like
+ * a transaction that carries data to the slave along with the read, sends
+ * its frame once and waits for the answer. The sequence number in the header rejects responses that
+ * belong to an earlier, timed out frame.
+ */
+#    define PIPELINE_NONE 0xFF
+
+enum { PIPELINE_IDLE, PIPELINE_SENT, PIPELINE_RECEIVED };
+
+typedef struct {
+    uint8_t state;
+    uint8_t index;
+    uint8_t header;
+    uint8_t buffer;  // which of the double buffers the frame uses
+    int     result;  // once received
+} pipeline_frame_t;
+
+static uint8_t            tx_frames[2][1 + SERIAL_USART_PIPELINE_BUFFER_SIZE];
+static uint8_t            rx_frames[2][1 + SERIAL_USART_PIPELINE_BUFFER_SIZE];
+static pipeline_frame_t   ahead     = {.state = PIPELINE_IDLE};
+static uint8_t            sequence  = 0;
+static uint8_t            last_read = PIPELINE_NONE;  // last pure read called
+static uint8_t            pipelined = PIPELINE_NONE;  // pure read whose frames are sent ahead
+static binary_semaphore_t rx_done;
+
+/* Master: the whole response frame arrived. */
+static void pipeline_master_rx_end(UARTDriver* uartp) {
+    (void)uartp;
+    chSysLockFromISR();
+    chBSemSignalI(&rx_done);
+    chSysUnlockFromISR();
+}
+
+/* Slave: a header byte arrived while idle, start receiving its payload right away. */
+static void pipeline_slave_header(UARTDriver* uartp, uint16_t received_header) {
+    uint8_t index = received_header & 0x0F;
+    if (index >= Transaction_table_size) {
+        return;
+    }
+
+    handshake     = (uint8_t)received_header;
+    SSTD_t* trans = &Transaction_table[index];
+    chSysLockFromISR();
+    if (trans->initiator2target_buffer_size) {
+        uartStartReceiveI(uartp, trans->initiator2target_buffer_size, trans->initiator2target_buffer);
+    }
+    chEvtSignalI(tp_target, (eventmask_t)SIGNAL_HANDSHAKE_RECEIVED);
+    chSysUnlockFromISR();
+}
+
+/* Slave: the payload following the header arrived. */
+static void pipeline_slave_rx_end(UARTDriver* uartp) {
+    (void)uartp;
+    chSysLockFromISR();
+    chEvtSignalI(tp_target, (eventmask_t)SIGNAL_PAYLOAD_RECEIVED);
+    chSysUnlockFromISR();
+}
+
+static void handle_transactions_slave_pipelined(uint8_t header) {
+    SSTD_t* trans = &Transaction_table[header & 0x0F];
+
+    if (trans->initiator2target_buffer_size) {
+        if (!chEvtWaitAnyTimeout((eventmask_t)SIGNAL_PAYLOAD_RECEIVED, TIME_MS2I(SERIAL_USART_TIMEOUT))) {
+            uartStopReceive(&SERIAL_USART_DRIVER);
+            if (trans->status) {
+                *trans->status = TRANSACTION_NO_RESPONSE;
+            }
+            return;
+        }
+    }
+
+    /* Answer with a single frame. */
+    uint8_t* frame = tx_frames[0];
+    frame[0]       = header ^ HANDSHAKE_MAGIC;
+    memcpy(&frame[1], trans->target2initiator_buffer, trans->target2initiator_buffer_size);
+    size_t buffer_size = (size_t)trans->target2initiator_buffer_size + 1;
+    msg_t  msg         = uartSendFullTimeout(&SERIAL_USART_DRIVER, &buffer_size, frame, TIME_MS2I(SERIAL_USART_TIMEOUT));
+
+    if (trans->status) {
+        *trans->status = (msg == MSG_OK) ? TRANSACTION_ACCEPTED : TRANSACTION_NO_RESPONSE;
+    }
+}
+
+/* Master: sends the request frame and starts receiving the response, without waiting. */
+static uint8_t pipeline_send(uint8_t index, uint8_t buffer) {
+    SSTD_t* const trans  = &Transaction_table[index];
+    uint8_t       header = (uint8_t)((sequence++ & 0x0F) << 4) | index;
+
+    uint8_t* tx = tx_frames[buffer];
+    tx[0]       = header;
+    memcpy(&tx[1], trans->initiator2target_buffer, trans->initiator2target_buffer_size);
+
+    chBSemReset(&rx_done, true);
+    uartStartReceive(&SERIAL_USART_DRIVER, (size_t)trans->target2initiator_buffer_size + 1, rx_frames[buffer]);
+    uartStartSend(&SERIAL_USART_DRIVER, (size_t)trans->initiator2target_buffer_size + 1, tx);
+    return header;
+}
+
+/* Master: waits for the response to the frame sent last, if it is not already there. */
+static int pipeline_wait(uint8_t header, uint8_t buffer) {
+    if (chBSemWaitTimeout(&rx_done, TIME_MS2I(SERIAL_USART_TIMEOUT)) != MSG_OK) {
+        uartStopReceive(&SERIAL_USART_DRIVER);
+        uartStopSend(&SERIAL_USART_DRIVER);
+        dprintln("USART: Receive Failed");
+        return TRANSACTION_NO_RESPONSE;
+    }
+
+    if (rx_frames[buffer][0] != (header ^ HANDSHAKE_MAGIC)) {
+        dprintln("USART: Sequence Mismatch");
+        return TRANSACTION_DATA_ERROR;
+    }
+    return TRANSACTION_END;
+}
+
+/* Master: hands the payload of a received frame over to the transaction. */
+static int pipeline_deliver(uint8_t index, uint8_t buffer, int result) {
+    SSTD_t* const trans = &Transaction_table[index];
+    if (result == TRANSACTION_END) {
+        memcpy(trans->target2initiator_buffer, &rx_frames[buffer][1], trans->target2initiator_buffer_size);
+    }
+    return result;
+}
+
+/* Master: sends the next frame of the pipelined read, replacing one that was received but never collected. */
+static void pipeline_send_ahead(uint8_t index, uint8_t buffer) {
+    ahead.index  = index;
+    ahead.buffer = buffer;
+    ahead.header = pipeline_send(index, buffer);
+    ahead.state  = PIPELINE_SENT;
+}
+
+static int transaction_pipelined(uint8_t sstd_index) {
+    SSTD_t* const trans = &Transaction_table[sstd_index];
+    /* The split transport's own payloads are checked at compile time, this catches keyboard ones. */
+    if (trans->initiator2target_buffer_size > SERIAL_USART_PIPELINE_BUFFER_SIZE || trans->target2initiator_buffer_size > SERIAL_USART_PIPELINE_BUFFER_SIZE) {
+        dprintf("USART: Transaction %u too large for SERIAL_USART_PIPELINE_BUFFER_SIZE\n", sstd_index);
+        return TRANSACTION_TYPE_ERROR;
+    }
+
+    if (trans->initiator2target_buffer_size == 0) {
+        if (sstd_index == last_read) {
+            pipelined = sstd_index;
+        }
+        last_read = sstd_index;
+    }
+
+    /* The frame sent ahead for this transaction was collected by now, most of the time. */
+    if (ahead.state != PIPELINE_IDLE && ahead.index == sstd_index) {
+        int result  = ahead.state == PIPELINE_SENT ? pipeline_wait(ahead.header, ahead.buffer) : ahead.result;
+        ahead.state = PIPELINE_IDLE;
+        result      = pipeline_deliver(sstd_index, ahead.buffer, result);
+        if (result == TRANSACTION_END && sstd_index == pipelined) {
+            pipeline_send_ahead(sstd_index, ahead.buffer ^ 1);
+        }
+        return result;
+    }
+
+    /* Let the frame sent ahead for another transaction land, it is kept for that transaction's next call. */
+    if (ahead.state == PIPELINE_SENT) {
+        ahead.result = pipeline_wait(ahead.header, ahead.buffer);
+        ahead.state  = PIPELINE_RECEIVED;
+    }
+
+    /* Run this transaction once, in the buffer the kept frame does not use. */
+    uint8_t buffer = ahead.state == PIPELINE_RECEIVED ? ahead.buffer ^ 1 : 0;
+    uint8_t header = pipeline_send(sstd_index, buffer);
+    int     result = pipeline_deliver(sstd_index, buffer, pipeline_wait(header, buffer));
+    if (result == TRANSACTION_END && sstd_index == pipelined) {
+        pipeline_send_ahead(sstd_index, buffer ^ 1);
+    }
+    return result;
+}
+#endif
 
 __attribute__((weak)) void usart_init(void) {
 #if defined(USE_GPIOV1)
@@ -111,7 +305,11 @@ static THD_FUNCTION(SlaveThread, arg) {
     while (true) {
         /* We sleep as long as there is no handshake waiting for us. */
         chEvtWaitAny((eventmask_t)SIGNAL_HANDSHAKE_RECEIVED);
+#if defined(SERIAL_USART_PIPELINE)
+        handle_transactions_slave_pipelined(handshake);
+#else
         handle_transactions_slave(handshake);
+#endif
     }
 }
 
@@ -127,7 +325,12 @@ void soft_serial_target_init(SSTD_t* const sstd_table, int sstd_table_size) {
     tp_target = chThdCreateStatic(waSlaveThread, sizeof(waSlaveThread), HIGHPRIO, SlaveThread, NULL);
 
     // Start receiving handshake tokens on slave halve
+#if defined(SERIAL_USART_PIPELINE)
+    uart_config.rxchar_cb = pipeline_slave_header;
+    uart_config.rxend_cb  = pipeline_slave_rx_end;
+#else
     uart_config.rxchar_cb = receive_transaction_handshake;
+#endif
     uartStart(&SERIAL_USART_DRIVER, &uart_config);
 }
 
@@ -195,6 +398,11 @@ void soft_serial_initiator_init(SSTD_t* const sstd_table, int sstd_table_size) {
     USART_REMAP;
 #endif
 
+#if defined(SERIAL_USART_PIPELINE)
+    chBSemObjectInit(&rx_done, true);
+    uart_config.rxend_cb = pipeline_master_rx_end;
+#endif
+
     uartStart(&SERIAL_USART_DRIVER, &uart_config);
 }
 
@@ -219,6 +427,9 @@ int soft_serial_transaction(int index) {
         return TRANSACTION_TYPE_ERROR;
     }
 
+#if defined(SERIAL_USART_PIPELINE)
+    return transaction_pipelined(sstd_index);
+#else
     SSTD_t* const trans       = &Transaction_table[sstd_index];
     msg_t         msg         = 0;
     size_t        buffer_size = (size_t)sizeof(sstd_index);
@@ -258,4 +469,5 @@ int soft_serial_transaction(int index) {
     }
 
     return TRANSACTION_END;
+#endif
 }
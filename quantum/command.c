@@ -206,6 +206,10 @@ static void print_status(void) {
     print_val_hex8(keymap_config.nkro);
 #endif
     print_val_hex32(timer_read32());
+    resolved_action_cache_debug();
+#ifdef MATRIX_IO_DELAY_CALIBRATE
+    matrix_io_delay_report();
+#endif
     return;
 }
 
@@ -0,0 +1,96 @@
+/*
+Copyright 2021 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Bit-sliced (vertical) millisecond counters shared by the *_bitsliced debounce algorithms.
+Bit n of every key's counter in a row is stored in planes[n], so one matrix_row_t
+operation updates the counters of all the keys of the row at once.
+*/
+
+#pragma once
+
+#include "matrix.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Enough bits to hold DEBOUNCE, counters never go above DEBOUNCE - 1
+#if DEBOUNCE < 2
+#    define DEBOUNCE_COUNTER_BITS 1
+#elif DEBOUNCE < 4
+#    define DEBOUNCE_COUNTER_BITS 2
+#elif DEBOUNCE < 8
+#    define DEBOUNCE_COUNTER_BITS 3
+#elif DEBOUNCE < 16
+#    define DEBOUNCE_COUNTER_BITS 4
+#elif DEBOUNCE < 32
+#    define DEBOUNCE_COUNTER_BITS 5
+#elif DEBOUNCE < 64
+#    define DEBOUNCE_COUNTER_BITS 6
+#elif DEBOUNCE < 128
+#    define DEBOUNCE_COUNTER_BITS 7
+#elif DEBOUNCE < 256
+#    define DEBOUNCE_COUNTER_BITS 8
+#else
+#    error DEBOUNCE must be less than 256 for the bit-sliced debounce algorithms
+#endif
+
+// Keys of the row whose counter is at least value
+static inline matrix_row_t bitsliced_counters_at_least(const matrix_row_t planes[], uint8_t value) {
+    matrix_row_t greater = 0;
+    matrix_row_t equal   = ~(matrix_row_t)0;
+    for (int8_t bit = DEBOUNCE_COUNTER_BITS - 1; bit >= 0; bit--) {
+        if (value & (1 << bit)) {
+            equal &= planes[bit];
+        } else {
+            greater |= equal & planes[bit];
+            equal &= ~planes[bit];
+        }
+    }
+    return greater | equal;
+}
+
+// Add value to the counters of the keys in mask
+static inline void bitsliced_counters_add(matrix_row_t planes[], matrix_row_t mask, uint8_t value) {
+    matrix_row_t carry = 0;
+    for (uint8_t bit = 0; bit < DEBOUNCE_COUNTER_BITS; bit++) {
+        matrix_row_t addend = (value & (1 << bit)) ? mask : 0;
+        matrix_row_t sum    = planes[bit] ^ addend ^ carry;
+        carry               = (planes[bit] & addend) | (carry & (planes[bit] ^ addend));
+        planes[bit]         = sum;
+    }
+}
+
+// Reset the counters of the keys in mask to zero
+static inline void bitsliced_counters_clear(matrix_row_t planes[], matrix_row_t mask) {
+    for (uint8_t bit = 0; bit < DEBOUNCE_COUNTER_BITS; bit++) {
+        planes[bit] &= ~mask;
+    }
+}
+
+/* Advance the counters of the keys in mask by elapsed milliseconds.
+ * Returns the keys that reached DEBOUNCE, their counters are reset to zero.
+ */
+static inline matrix_row_t bitsliced_counters_advance(matrix_row_t planes[], matrix_row_t mask, uint16_t elapsed) {
+    matrix_row_t expired;
+    if (elapsed >= DEBOUNCE) {
+        expired = mask;
+    } else {
+        expired = bitsliced_counters_at_least(planes, DEBOUNCE - elapsed) & mask;
+        bitsliced_counters_add(planes, mask & ~expired, elapsed);
+    }
+    bitsliced_counters_clear(planes, expired);
+    return expired;
+}
@@ -0,0 +1,83 @@
+/*
+Copyright 2021 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Symmetric per-key algorithm, same behaviour as sym_defer_pk.
+When no state changes have occured for DEBOUNCE milliseconds, we push the state.
+The per-key counters are bit-sliced, so each row is debounced with a few bitwise operations
+and no memory allocation is needed.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "debounce.h"
+#include "bitsliced_counters.h"
+
+#if DEBOUNCE > 0
+static matrix_row_t counters[MATRIX_ROWS][DEBOUNCE_COUNTER_BITS];
+static matrix_row_t debouncing[MATRIX_ROWS];
+static uint16_t     last_time;
+static bool         debounce_pending;
+
+void debounce_init(uint8_t num_rows) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        bitsliced_counters_clear(counters[row], ~(matrix_row_t)0);
+        debouncing[row] = 0;
+    }
+    last_time        = timer_read();
+    debounce_pending = false;
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint16_t now     = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, last_time);
+    last_time        = now;
+
+    if (!changed && !debounce_pending) {
+        return;
+    }
+
+    debounce_pending = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta    = raw[row] ^ cooked[row];
+        matrix_row_t counting = debouncing[row];
+
+        // keys that went back to their debounced state start over
+        bitsliced_counters_clear(counters[row], counting & ~delta);
+        counting &= delta;
+
+        if (elapsed && counting) {
+            matrix_row_t expired = bitsliced_counters_advance(counters[row], counting, elapsed);
+            cooked[row] ^= expired;
+            delta &= ~expired;
+        }
+
+        // keys that just changed start counting from zero
+        debouncing[row] = delta;
+        if (delta) {
+            debounce_pending = true;
+        }
+    }
+}
+#else  // no debouncing.
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        cooked[row] = raw[row];
+    }
+}
+#endif
+
+bool debounce_active(void) { return true; }
@@ -0,0 +1,81 @@
+/*
+Copyright 2021 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Symmetric per-key algorithm, same behaviour as sym_eager_pk.
+After pressing a key, it immediately changes state, and starts a counter.
+No further inputs are accepted until DEBOUNCE milliseconds have occurred.
+The per-key counters are bit-sliced, so each row is debounced with a few bitwise operations
+and no memory allocation is needed.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "debounce.h"
+#include "bitsliced_counters.h"
+
+#if DEBOUNCE > 0
+static matrix_row_t counters[MATRIX_ROWS][DEBOUNCE_COUNTER_BITS];
+static matrix_row_t locked[MATRIX_ROWS];
+static uint16_t     last_time;
+static bool         debounce_pending;
+
+void debounce_init(uint8_t num_rows) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        bitsliced_counters_clear(counters[row], ~(matrix_row_t)0);
+        locked[row] = 0;
+    }
+    last_time        = timer_read();
+    debounce_pending = false;
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint16_t now     = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, last_time);
+    last_time        = now;
+
+    if (!changed && !debounce_pending) {
+        return;
+    }
+
+    debounce_pending = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t row_locked = locked[row];
+
+        if (elapsed && row_locked) {
+            row_locked &= ~bitsliced_counters_advance(counters[row], row_locked, elapsed);
+        }
+
+        // unlocked keys follow the raw state immediately, then get locked
+        matrix_row_t delta = (raw[row] ^ cooked[row]) & ~row_locked;
+        cooked[row] ^= delta;
+        row_locked |= delta;
+
+        locked[row] = row_locked;
+        if (row_locked) {
+            debounce_pending = true;
+        }
+    }
+}
+#else  // no debouncing.
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        cooked[row] = raw[row];
+    }
+}
+#endif
+
+bool debounce_active(void) { return true; }
@@ -0,0 +1,119 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include "debounce_test_common.h"
+
+TEST_F(DebounceTest, OneKeyShort1) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}}, {{0, 1, DOWN}}},
+        {1, {{0, 1, UP}}, {}},
+
+        {6, {}, {{0, 1, UP}}},
+        /* Press again immediately after the release is reported */
+        {7, {{0, 1, DOWN}}, {{0, 1, DOWN}}},
+        {8, {{0, 1, UP}}, {}},
+
+        {13, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, OneKeyLongPress) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}}, {{0, 1, DOWN}}},
+        {50, {{0, 1, UP}}, {}},
+        {55, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, OneKeyPressChatter) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        /* Press is reported on the first edge */
+        {0, {{0, 1, DOWN}}, {{0, 1, DOWN}}},
+        /* Contact bounce while pressed must not cause a release */
+        {1, {{0, 1, UP}}, {}},
+        {2, {{0, 1, DOWN}}, {}},
+        {3, {{0, 1, UP}}, {}},
+        {4, {{0, 1, DOWN}}, {}},
+        {6, {{0, 1, UP}}, {}},
+        {10, {{0, 1, DOWN}}, {}},
+        /* Release bounces too, only the stable release is reported */
+        {30, {{0, 1, UP}}, {}},
+        {31, {{0, 1, DOWN}}, {}},
+        {33, {{0, 1, UP}}, {}},
+        {34, {{0, 1, DOWN}}, {}},
+        {35, {{0, 1, UP}}, {}},
+        {40, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, OneKeyReleaseInterruptedJustBeforeDeadline) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}}, {{0, 1, DOWN}}},
+        {10, {{0, 1, UP}}, {}},
+        /* 4ms of release is not enough, the timer restarts */
+        {14, {{0, 1, DOWN}}, {}},
+        {15, {{0, 1, UP}}, {}},
+        {20, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, OneKeyNoiseWhileReleasedIsAPress) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        /* Eager press: a single-scan blip is reported, then released after DEBOUNCE */
+        {0, {{0, 1, DOWN}}, {{0, 1, DOWN}}},
+        {1, {{0, 1, UP}}, {}},
+        {6, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, TwoKeysChatterIndependently) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}}, {{0, 1, DOWN}}},
+        {1, {{0, 1, UP}, {0, 2, DOWN}}, {{0, 2, DOWN}}},
+        {2, {{0, 1, DOWN}, {0, 2, UP}}, {}},
+        {3, {{0, 2, DOWN}}, {}},
+        {20, {{0, 1, UP}}, {}},
+        {22, {{0, 2, UP}}, {}},
+        {25, {}, {{0, 1, UP}}},
+        {27, {}, {{0, 2, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, TwoKeysDifferentRows) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}, {3, 9, DOWN}}, {{0, 1, DOWN}, {3, 9, DOWN}}},
+        {5, {{0, 1, UP}}, {}},
+        {7, {{3, 9, UP}}, {}},
+        {10, {}, {{0, 1, UP}}},
+        {12, {}, {{3, 9, UP}}},
+    });
+    runEvents();
+}
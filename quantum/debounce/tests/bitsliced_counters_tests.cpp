@@ -0,0 +1,52 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+extern "C" {
+#include "debounce/bitsliced_counters.h"
+}
+
+// Checks the bit-sliced counters against one plain counter per column,
+// including scans that are further apart than 1ms
+TEST(BitslicedCounters, AdvanceMatchesPerKeyCounters) {
+    matrix_row_t planes[DEBOUNCE_COUNTER_BITS] = {0};
+    unsigned     expected[MATRIX_COLS]         = {0};
+
+    srand(1);
+    for (int step = 0; step < 10000; step++) {
+        matrix_row_t mask    = rand() & ((MATRIX_ROW_SHIFTER << MATRIX_COLS) - 1);
+        uint16_t     elapsed = rand() % (DEBOUNCE + 2);
+
+        matrix_row_t expired = bitsliced_counters_advance(planes, mask, elapsed);
+
+        for (int col = 0; col < MATRIX_COLS; col++) {
+            matrix_row_t col_mask = MATRIX_ROW_SHIFTER << col;
+            if (mask & col_mask) {
+                expected[col] += elapsed;
+                ASSERT_EQ(!!(expired & col_mask), expected[col] >= DEBOUNCE) << "column " << col << " at step " << step;
+                if (expected[col] >= DEBOUNCE) {
+                    expected[col] = 0;
+                }
+            } else {
+                ASSERT_FALSE(expired & col_mask);
+            }
+            ASSERT_EQ(!!(bitsliced_counters_at_least(planes, 1) & col_mask), expected[col] >= 1) << "column " << col << " at step " << step;
+        }
+    }
+}
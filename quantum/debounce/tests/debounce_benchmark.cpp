@@ -0,0 +1,151 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+
+extern "C" {
+#include "quantum.h"
+#include "timer.h"
+#include "debounce.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+/* Measures the CPU time of one debounce() call, on the host, so algorithms can
+ * be compared against each other for a given matrix. The absolute numbers
+ * don't carry over to a microcontroller, the ratios mostly do.
+ */
+
+#define STR_(x) #x
+#define STR(x) STR_(x)
+
+// Like split_common, each half only debounces its own rows
+#ifdef SPLIT_KEYBOARD
+#    define DEBOUNCE_BENCHMARK_ROWS (MATRIX_ROWS / 2)
+#else
+#    define DEBOUNCE_BENCHMARK_ROWS MATRIX_ROWS
+#endif
+
+#define DEBOUNCE_BENCHMARK_MS 10000
+#define DEBOUNCE_BENCHMARK_SCANS_PER_MS 8
+// How often a key goes down or up, and how many times its contacts bounce when it does
+#define DEBOUNCE_BENCHMARK_KEYSTROKE_MS 40
+#define DEBOUNCE_BENCHMARK_MAX_BOUNCES 4
+#define DEBOUNCE_BENCHMARK_MAX_HELD 4
+
+class DebounceBenchmark : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        std::fill(std::begin(raw_), std::end(raw_), 0);
+        std::fill(std::begin(cooked_), std::end(cooked_), 0);
+        set_time(0);
+        debounce_init(DEBOUNCE_BENCHMARK_ROWS);
+    }
+
+    // Deterministic, so every algorithm sees the same timeline
+    uint32_t next_random() {
+        random_ = random_ * 1103515245 + 12345;
+        return random_ >> 16;
+    }
+
+    void report(const char *name, std::chrono::nanoseconds elapsed, unsigned scans) {
+        double ns_per_scan = static_cast<double>(elapsed.count()) / scans;
+        std::cout << STR(DEBOUNCE_BENCHMARK_ALGORITHM) << " " << STR(DEBOUNCE_BENCHMARK_LAYOUT) << ": " << ns_per_scan << " ns per " << name << " scan" << std::endl;
+        RecordProperty(std::string("ns_per_") + name + "_scan", static_cast<int>(ns_per_scan));
+    }
+
+    matrix_row_t raw_[DEBOUNCE_BENCHMARK_ROWS];
+    matrix_row_t cooked_[DEBOUNCE_BENCHMARK_ROWS];
+    uint32_t     random_ = 1;
+};
+
+TEST_F(DebounceBenchmark, IdleScan) {
+    const unsigned           scans = DEBOUNCE_BENCHMARK_MS * DEBOUNCE_BENCHMARK_SCANS_PER_MS;
+    std::chrono::nanoseconds elapsed(0);
+
+    for (unsigned ms = 0; ms < DEBOUNCE_BENCHMARK_MS; ms++, advance_time(1)) {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned scan = 0; scan < DEBOUNCE_BENCHMARK_SCANS_PER_MS; scan++) {
+            debounce(raw_, cooked_, DEBOUNCE_BENCHMARK_ROWS, false);
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    report("idle", elapsed, scans);
+}
+
+TEST_F(DebounceBenchmark, TypingScan) {
+    const unsigned           scans = DEBOUNCE_BENCHMARK_MS * DEBOUNCE_BENCHMARK_SCANS_PER_MS;
+    std::chrono::nanoseconds elapsed(0);
+    unsigned                 held       = 0;
+    unsigned                 bouncing   = 0;
+    uint8_t                  key_row    = 0;
+    matrix_row_t             key_mask   = 0;
+    unsigned                 next_press = 0;
+
+    for (unsigned ms = 0; ms < DEBOUNCE_BENCHMARK_MS; ms++, advance_time(1)) {
+        bool changed = false;
+
+        if (bouncing > 0) {
+            raw_[key_row] ^= key_mask;
+            bouncing--;
+            changed = true;
+        } else if (ms >= next_press) {
+            // Pick a key to press, or release one that is already held
+            key_row  = next_random() % DEBOUNCE_BENCHMARK_ROWS;
+            key_mask = MATRIX_ROW_SHIFTER << (next_random() % MATRIX_COLS);
+            if (held >= DEBOUNCE_BENCHMARK_MAX_HELD && !(raw_[key_row] & key_mask)) {
+                for (uint8_t row = 0; row < DEBOUNCE_BENCHMARK_ROWS; row++) {
+                    if (raw_[row]) {
+                        key_row  = row;
+                        key_mask = raw_[row] & -raw_[row];
+                        break;
+                    }
+                }
+            }
+            if (raw_[key_row] & key_mask) {
+                held--;
+            } else {
+                held++;
+            }
+            raw_[key_row] ^= key_mask;
+            // An even number of extra toggles, so the key ends up where it was sent
+            bouncing   = 2 * (next_random() % (DEBOUNCE_BENCHMARK_MAX_BOUNCES / 2 + 1));
+            next_press = ms + 1 + next_random() % (2 * DEBOUNCE_BENCHMARK_KEYSTROKE_MS);
+            changed    = true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned scan = 0; scan < DEBOUNCE_BENCHMARK_SCANS_PER_MS; scan++) {
+            debounce(raw_, cooked_, DEBOUNCE_BENCHMARK_ROWS, changed && scan == 0);
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    report("typing", elapsed, scans);
+
+    // Whatever the algorithm, the cooked matrix must settle on the raw one
+    for (unsigned ms = 0; ms < 50; ms++, advance_time(1)) {
+        debounce(raw_, cooked_, DEBOUNCE_BENCHMARK_ROWS, false);
+    }
+    EXPECT_TRUE(std::equal(std::begin(raw_), std::end(raw_), std::begin(cooked_)));
+}
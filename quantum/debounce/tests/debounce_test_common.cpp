@@ -0,0 +1,106 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+
+#include <algorithm>
+#include <sstream>
+
+// How long to keep scanning after the last event, to catch late or spurious changes
+#define DEBOUNCE_TEST_TAIL_MS 50
+// The timeline is replayed with 1 up to this many scans per millisecond
+#define DEBOUNCE_TEST_MAX_SCANS_PER_MS 5
+
+MatrixTestEvent::MatrixTestEvent(int row, int col, bool pressed) : row_(row), col_(col), pressed_(pressed) {}
+
+DebounceTestEvent::DebounceTestEvent(uint32_t time, std::initializer_list<MatrixTestEvent> inputs, std::initializer_list<MatrixTestEvent> outputs) : time_(time), inputs_(inputs), outputs_(outputs) {}
+
+void DebounceTest::addEvents(std::initializer_list<DebounceTestEvent> events) { events_.insert(events_.end(), events.begin(), events.end()); }
+
+void DebounceTest::runEvents() {
+    for (extra_iterations_ = 0; extra_iterations_ < DEBOUNCE_TEST_MAX_SCANS_PER_MS && !HasFailure(); extra_iterations_++) {
+        runEventsInternal();
+    }
+}
+
+void DebounceTest::runEventsInternal() {
+    std::fill(std::begin(raw_matrix_), std::end(raw_matrix_), 0);
+    std::fill(std::begin(cooked_matrix_), std::end(cooked_matrix_), 0);
+    std::fill(std::begin(output_matrix_), std::end(output_matrix_), 0);
+
+    set_time(0);
+    debounce_init(MATRIX_ROWS);
+
+    auto     event = events_.begin();
+    uint32_t end   = events_.empty() ? 0 : events_.back().time_;
+
+    for (uint32_t now = 0; now <= end + DEBOUNCE_TEST_TAIL_MS; now++, advance_time(1)) {
+        bool changed = false;
+
+        if (event != events_.end() && event->time_ == now) {
+            for (auto &input : event->inputs_) {
+                matrix_row_t col_mask = MATRIX_ROW_SHIFTER << input.col_;
+                if (input.pressed_) {
+                    raw_matrix_[input.row_] |= col_mask;
+                } else {
+                    raw_matrix_[input.row_] &= ~col_mask;
+                }
+                changed = true;
+            }
+            for (auto &output : event->outputs_) {
+                matrix_row_t col_mask = MATRIX_ROW_SHIFTER << output.col_;
+                if (output.pressed_) {
+                    output_matrix_[output.row_] |= col_mask;
+                } else {
+                    output_matrix_[output.row_] &= ~col_mask;
+                }
+            }
+            event++;
+        }
+
+        for (unsigned scan = 0; scan <= extra_iterations_; scan++) {
+            runDebounce(changed && scan == 0);
+
+            std::stringstream message;
+            message << "at " << now << "ms, scan " << scan + 1 << " of " << extra_iterations_ + 1 << " in that ms";
+            checkCookedMatrix(message.str());
+            if (HasFailure()) {
+                return;
+            }
+        }
+    }
+}
+
+void DebounceTest::runDebounce(bool changed) { debounce(raw_matrix_, cooked_matrix_, MATRIX_ROWS, changed); }
+
+void DebounceTest::checkCookedMatrix(const std::string &error_message) {
+    if (!std::equal(std::begin(output_matrix_), std::end(output_matrix_), std::begin(cooked_matrix_))) {
+        FAIL() << "Unexpected cooked matrix " << error_message << "\nExpected:\n" << strMatrix(output_matrix_) << "\nActual:\n" << strMatrix(cooked_matrix_);
+    }
+}
+
+std::string DebounceTest::strMatrix(matrix_row_t matrix[]) {
+    std::stringstream buffer;
+
+    for (int row = 0; row < MATRIX_ROWS; row++) {
+        buffer << "  " << row << ": ";
+        for (int col = 0; col < MATRIX_COLS; col++) {
+            buffer << ((matrix[row] & (MATRIX_ROW_SHIFTER << col)) ? "1" : "0");
+        }
+        buffer << "\n";
+    }
+    return buffer.str();
+}
@@ -0,0 +1,77 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <initializer_list>
+#include <list>
+#include <string>
+
+extern "C" {
+#include "quantum.h"
+#include "timer.h"
+#include "debounce.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+class MatrixTestEvent {
+   public:
+    MatrixTestEvent(int row, int col, bool pressed);
+
+    const int  row_;
+    const int  col_;
+    const bool pressed_;
+};
+
+class DebounceTestEvent {
+   public:
+    // 0, {{0, 1, DOWN}}, {{0, 1, DOWN}})
+    DebounceTestEvent(uint32_t time, std::initializer_list<MatrixTestEvent> inputs, std::initializer_list<MatrixTestEvent> outputs);
+
+    const uint32_t             time_;
+    std::list<MatrixTestEvent> inputs_;
+    std::list<MatrixTestEvent> outputs_;
+};
+
+/* Replays a timeline of raw matrix changes through debounce(), scanning once
+ * per millisecond (and again with several scans per millisecond), and checks
+ * the cooked matrix only changes at the times and in the way listed in the outputs.
+ */
+class DebounceTest : public ::testing::Test {
+   protected:
+    void addEvents(std::initializer_list<DebounceTestEvent> events);
+    void runEvents();
+
+   private:
+    void        runEventsInternal();
+    void        runDebounce(bool changed);
+    void        checkCookedMatrix(const std::string &error_message);
+    std::string strMatrix(matrix_row_t matrix[]);
+
+    std::list<DebounceTestEvent> events_;
+    unsigned                     extra_iterations_;
+
+    matrix_row_t raw_matrix_[MATRIX_ROWS];
+    matrix_row_t cooked_matrix_[MATRIX_ROWS];
+    matrix_row_t output_matrix_[MATRIX_ROWS];
+};
+
+#define DOWN true
+#define UP false
@@ -0,0 +1,76 @@
+# Copyright 2021 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+DEBOUNCE_COMMON_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=10 -DDEBOUNCE=5
+
+DEBOUNCE_COMMON_SRC := $(QUANTUM_PATH)/debounce/tests/debounce_test_common.cpp \
+	$(TMK_PATH)/common/test/timer.c
+
+debounce_sym_defer_g_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_g_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_g.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_g_tests.cpp
+
+debounce_sym_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_tests.cpp
+
+debounce_sym_defer_bitsliced_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_bitsliced_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_bitsliced.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_tests.cpp \
+	$(QUANTUM_PATH)/debounce/tests/bitsliced_counters_tests.cpp
+
+debounce_sym_eager_pr_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_eager_pr_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pr.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pr_tests.cpp
+
+debounce_sym_eager_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_eager_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pk.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_tests.cpp
+
+debounce_sym_eager_bitsliced_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_eager_bitsliced_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_bitsliced.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_tests.cpp \
+	$(QUANTUM_PATH)/debounce/tests/bitsliced_counters_tests.cpp
+
+debounce_asym_eager_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_asym_eager_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/asym_eager_defer_pk.c \
+	$(QUANTUM_PATH)/debounce/tests/asym_eager_defer_pk_tests.cpp
+
+# Benchmarks: every algorithm on a few representative matrices.
+# Run e.g. `make test:debounce_sym_defer_pk_benchmark_8x22`.
+DEBOUNCE_BENCHMARK_ALGORITHMS := sym_defer_g sym_defer_pk sym_defer_bitsliced sym_eager_pr sym_eager_pk sym_eager_bitsliced asym_eager_defer_pk
+
+DEBOUNCE_BENCHMARK_LAYOUT_5x15 := -DMATRIX_ROWS=5 -DMATRIX_COLS=15
+DEBOUNCE_BENCHMARK_LAYOUT_8x22 := -DMATRIX_ROWS=8 -DMATRIX_COLS=22
+DEBOUNCE_BENCHMARK_LAYOUT_split_10x7 := -DMATRIX_ROWS=10 -DMATRIX_COLS=7 -DSPLIT_KEYBOARD
+
+DEBOUNCE_BENCHMARK_LAYOUTS := 5x15 8x22 split_10x7
+
+define DEBOUNCE_BENCHMARK
+debounce_$1_benchmark_$2_DEFS := $$(DEBOUNCE_BENCHMARK_LAYOUT_$2) -DDEBOUNCE=5 \
+	-DDEBOUNCE_BENCHMARK_ALGORITHM=$1 -DDEBOUNCE_BENCHMARK_LAYOUT=$2
+debounce_$1_benchmark_$2_SRC := $(TMK_PATH)/common/test/timer.c \
+	$(QUANTUM_PATH)/debounce/$1.c \
+	$(QUANTUM_PATH)/debounce/tests/debounce_benchmark.cpp
+endef
+
+$(foreach ALGORITHM,$(DEBOUNCE_BENCHMARK_ALGORITHMS),$(foreach LAYOUT,$(DEBOUNCE_BENCHMARK_LAYOUTS),$(eval $(call DEBOUNCE_BENCHMARK,$(ALGORITHM),$(LAYOUT)))))
@@ -0,0 +1,14 @@
+TEST_LIST +=\
+	debounce_sym_defer_g\
+	debounce_sym_defer_pk\
+	debounce_sym_defer_bitsliced\
+	debounce_sym_eager_pr\
+	debounce_sym_eager_pk\
+	debounce_sym_eager_bitsliced\
+	debounce_asym_eager_defer_pk
+
+# Names have to match the ones generated in rules.mk
+DEBOUNCE_BENCHMARK_TESTS := $(foreach ALGORITHM,sym_defer_g sym_defer_pk sym_defer_bitsliced sym_eager_pr sym_eager_pk sym_eager_bitsliced asym_eager_defer_pk,\
+	$(foreach LAYOUT,5x15 8x22 split_10x7,debounce_$(ALGORITHM)_benchmark_$(LAYOUT)))
+
+TEST_LIST += $(DEBOUNCE_BENCHMARK_TESTS)
@@ -30,6 +30,10 @@
 #    define DYNAMIC_KEYMAP_MACRO_COUNT 16
 #endif
 
+// Size in bytes of one layer / all layers of the keymap in EEPROM
+#define DYNAMIC_KEYMAP_LAYER_SIZE (MATRIX_ROWS * MATRIX_COLS * 2)
+#define DYNAMIC_KEYMAP_EEPROM_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * DYNAMIC_KEYMAP_LAYER_SIZE)
+
 // This is the default EEPROM max address to use for dynamic keymaps.
 // The default is the ATmega32u4 EEPROM max address.
 // Explicitly override it if the keyboard uses a microcontroller with
@@ -63,7 +67,7 @@
 
 // Dynamic macro starts after dynamic keymaps
 #ifndef DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR
-#    define DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR (DYNAMIC_KEYMAP_EEPROM_ADDR + (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2))
+#    define DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR (DYNAMIC_KEYMAP_EEPROM_ADDR + DYNAMIC_KEYMAP_EEPROM_SIZE)
 #endif
 
 // Sanity check that dynamic keymaps fit in available EEPROM
@@ -81,6 +85,66 @@
 #    define DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR - DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + 1)
 #endif
 
+// Optional RAM copy of the dynamic keymaps, so key lookups don't have to go
+// through EEPROM (slow on flash-emulated and I2C EEPROMs).
+// DYNAMIC_KEYMAP_CACHE_MAX_SIZE is the SRAM budget in bytes. Only as many
+// layers as fit in the budget are cached, the others are still read from EEPROM.
+#ifdef DYNAMIC_KEYMAP_CACHE_ENABLE
+#    ifndef DYNAMIC_KEYMAP_CACHE_MAX_SIZE
+#        if defined(__AVR__)
+#            define DYNAMIC_KEYMAP_CACHE_MAX_SIZE 512
+#        else
+#            define DYNAMIC_KEYMAP_CACHE_MAX_SIZE 4096
+#        endif
+#    endif
+#    if DYNAMIC_KEYMAP_EEPROM_SIZE <= DYNAMIC_KEYMAP_CACHE_MAX_SIZE
+#        define DYNAMIC_KEYMAP_CACHE_LAYERS DYNAMIC_KEYMAP_LAYER_COUNT
+#    else
+#        define DYNAMIC_KEYMAP_CACHE_LAYERS (DYNAMIC_KEYMAP_CACHE_MAX_SIZE / DYNAMIC_KEYMAP_LAYER_SIZE)
+#    endif
+#else
+#    define DYNAMIC_KEYMAP_CACHE_LAYERS 0
+#endif
+#define DYNAMIC_KEYMAP_CACHE_SIZE (DYNAMIC_KEYMAP_CACHE_LAYERS * DYNAMIC_KEYMAP_LAYER_SIZE)
+
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+static uint16_t dynamic_keymap_cache[DYNAMIC_KEYMAP_CACHE_LAYERS][MATRIX_ROWS][MATRIX_COLS];
+static bool     dynamic_keymap_cache_loaded = false;
+
+static uint16_t dynamic_keymap_read_keycode(uint8_t layer, uint8_t row, uint8_t column);
+
+static void dynamic_keymap_cache_load(void) {
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_CACHE_LAYERS; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t column = 0; column < MATRIX_COLS; column++) {
+                dynamic_keymap_cache[layer][row][column] = dynamic_keymap_read_keycode(layer, row, column);
+            }
+        }
+    }
+    dynamic_keymap_cache_loaded = true;
+}
+
+// Offset is in bytes into the big-endian EEPROM layout
+static void dynamic_keymap_cache_update_byte(uint16_t offset, uint8_t value) {
+    if (!dynamic_keymap_cache_loaded || offset >= DYNAMIC_KEYMAP_CACHE_SIZE) {
+        return;
+    }
+    uint16_t *keycode = &((uint16_t *)dynamic_keymap_cache)[offset / 2];
+    if (offset & 1) {
+        *keycode = (*keycode & 0xFF00) | value;
+    } else {
+        *keycode = (*keycode & 0x00FF) | (value << 8);
+    }
+}
+#endif
+
+void dynamic_keymap_init(void) {
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+    // Read the cached layers from EEPROM now rather than on the first keypress
+    dynamic_keymap_cache_load();
+#endif
+}
+
 uint8_t dynamic_keymap_get_layer_count(void) { return DYNAMIC_KEYMAP_LAYER_COUNT; }
 
 void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t column) {
@@ -88,7 +152,7 @@ void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t c
     return ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + (layer * MATRIX_ROWS * MATRIX_COLS * 2) + (row * MATRIX_COLS * 2) + (column * 2);
 }
 
-uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+static uint16_t dynamic_keymap_read_keycode(uint8_t layer, uint8_t row, uint8_t column) {
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
     uint16_t keycode = eeprom_read_byte(address) << 8;
@@ -96,11 +160,26 @@ uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column)
     return keycode;
 }
 
+uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+    if (layer < DYNAMIC_KEYMAP_CACHE_LAYERS && dynamic_keymap_cache_loaded) {
+        return dynamic_keymap_cache[layer][row][column];
+    }
+#endif
+    return dynamic_keymap_read_keycode(layer, row, column);
+}
+
 void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
     eeprom_update_byte(address, (uint8_t)(keycode >> 8));
     eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+    if (layer < DYNAMIC_KEYMAP_CACHE_LAYERS && dynamic_keymap_cache_loaded) {
+        dynamic_keymap_cache[layer][row][column] = keycode;
+    }
+#endif
+    clear_resolved_action_cache();
 }
 
 void dynamic_keymap_reset(void) {
@@ -117,11 +196,10 @@ void dynamic_keymap_reset(void) {
 }
 
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   source                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *target                     = data;
+    void *   source = (void *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
+    uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
+        if (offset + i < DYNAMIC_KEYMAP_EEPROM_SIZE) {
             *target = eeprom_read_byte(source);
         } else {
             *target = 0x00;
@@ -132,16 +210,19 @@ void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
 }
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   target                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *source                     = data;
+    void *   target = (void *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
+    uint8_t *source = data;
     for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
+        if (offset + i < DYNAMIC_KEYMAP_EEPROM_SIZE) {
             eeprom_update_byte(target, *source);
+#if DYNAMIC_KEYMAP_CACHE_LAYERS > 0
+            dynamic_keymap_cache_update_byte(offset + i, *source);
+#endif
         }
         source++;
         target++;
     }
+    clear_resolved_action_cache();
 }
 
 // This overrides the one in quantum/keymap_common.c
@@ -158,7 +239,7 @@ uint8_t dynamic_keymap_macro_get_count(void) { return DYNAMIC_KEYMAP_MACRO_COUNT
 uint16_t dynamic_keymap_macro_get_buffer_size(void) { return DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE; }
 
 void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   source = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   source = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
     uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
@@ -172,7 +253,7 @@ void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *da
 }
 
 void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   target = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   target = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
     uint8_t *source = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
@@ -184,8 +265,8 @@ void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *da
 }
 
 void dynamic_keymap_macro_reset(void) {
-    void *p   = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
-    void *end = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
+    void *p   = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
+    void *end = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
     while (p != end) {
         eeprom_update_byte(p, 0);
         ++p;
@@ -201,15 +282,15 @@ void dynamic_keymap_macro_send(uint8_t id) {
     // If it's not zero, then we are in the middle
     // of buffer writing, possibly an aborted buffer
     // write. So do nothing.
-    void *p = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - 1);
+    void *p = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - 1);
     if (eeprom_read_byte(p) != 0) {
         return;
     }
 
     // Skip N null characters
     // p will then point to the Nth macro
-    p         = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
-    void *end = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
+    p         = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
+    void *end = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
     while (id > 0) {
         // If we are past the end of the buffer, then the buffer
         // contents are garbage, i.e. there were not DYNAMIC_KEYMAP_MACRO_COUNT
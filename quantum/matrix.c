@@ -20,6 +20,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "debounce.h"
 #include "quantum.h"
+#include "scan_profile.h"
+#ifdef MATRIX_WAKE_ENABLE
+#    include "matrix_wake.h"
+#endif
 
 #ifdef DIRECT_PINS
 static pin_t direct_pins[MATRIX_ROWS][MATRIX_COLS] = DIRECT_PINS;
@@ -79,6 +83,9 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
 
 #elif defined(DIODE_DIRECTION)
 #    if (DIODE_DIRECTION == COL2ROW)
+#        ifdef MATRIX_PORT_GROUPED_READ
+#            include "matrix_ports.h"
+#        endif
 
 static void select_row(uint8_t row) { setPinOutput_writeLow(row_pins[row]); }
 
@@ -95,6 +102,9 @@ static void init_pins(void) {
     for (uint8_t x = 0; x < MATRIX_COLS; x++) {
         setPinInputHigh_atomic(col_pins[x]);
     }
+#        ifdef MATRIX_PORT_GROUPED_READ
+    matrix_ports_init(col_pins);
+#        endif
 }
 
 static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row) {
@@ -105,6 +115,10 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
     select_row(current_row);
     matrix_output_select_delay();
 
+#        ifdef MATRIX_PORT_GROUPED_READ
+    // Read each port once, active low
+    current_row_value = matrix_ports_read_low(col_pins);
+#        else
     // For each col...
     for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++) {
         // Select the col pin to read (active low)
@@ -113,6 +127,7 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
         // Populate the matrix row with the state of the col pin
         current_row_value |= pin_state ? 0 : (MATRIX_ROW_SHIFTER << col_index);
     }
+#        endif
 
     // Unselect row
     unselect_row(current_row);
@@ -188,9 +203,71 @@ static bool read_rows_on_col(matrix_row_t current_matrix[], uint8_t current_col)
 #    error DIODE_DIRECTION is not defined!
 #endif
 
+#ifdef MATRIX_WAKE_ENABLE
+#    ifdef DIRECT_PINS
+#        define WAKE_INPUT_PINS ((const pin_t *)direct_pins)
+#        define WAKE_INPUT_COUNT (MATRIX_ROWS * MATRIX_COLS)
+#    elif (DIODE_DIRECTION == COL2ROW)
+#        define WAKE_INPUT_PINS col_pins
+#        define WAKE_INPUT_COUNT MATRIX_COLS
+#    else
+#        define WAKE_INPUT_PINS row_pins
+#        define WAKE_INPUT_COUNT MATRIX_ROWS
+#    endif
+
+void matrix_wake_arm_pins(void) {
+#    if !defined(DIRECT_PINS)
+    // Drive every output, so that any key pulls its input low
+#        if (DIODE_DIRECTION == COL2ROW)
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        select_row(row);
+    }
+#        else
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        select_col(col);
+    }
+#        endif
+    matrix_output_select_delay();
+#    endif
+    matrix_wake_enable_interrupts(WAKE_INPUT_PINS, WAKE_INPUT_COUNT);
+}
+
+void matrix_wake_disarm_pins(void) {
+    matrix_wake_disable_interrupts(WAKE_INPUT_PINS, WAKE_INPUT_COUNT);
+#    if !defined(DIRECT_PINS)
+#        if (DIODE_DIRECTION == COL2ROW)
+    unselect_rows();
+#        else
+    unselect_cols();
+#        endif
+    matrix_output_unselect_delay();
+#    endif
+}
+
+bool matrix_wake_inputs_idle(void) {
+    const pin_t *pins = WAKE_INPUT_PINS;
+    for (uint16_t i = 0; i < WAKE_INPUT_COUNT; i++) {
+        if (pins[i] != NO_PIN && !readPin(pins[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 void matrix_init(void) {
     // initialize key pins
     init_pins();
+#if defined(MATRIX_IO_DELAY_CALIBRATE) && !defined(DIRECT_PINS)
+#    if (DIODE_DIRECTION == COL2ROW)
+    matrix_io_delay_calibrate(col_pins, MATRIX_COLS);
+#    else
+    matrix_io_delay_calibrate(row_pins, MATRIX_ROWS);
+#    endif
+#endif
+#ifdef MATRIX_WAKE_ENABLE
+    matrix_wake_init();
+#endif
 
     // initialize matrix state: all keys off
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
@@ -206,6 +283,13 @@ void matrix_init(void) {
 uint8_t matrix_scan(void) {
     bool changed = false;
 
+#ifdef MATRIX_WAKE_ENABLE
+    if (matrix_wake_idle()) {
+        matrix_scan_quantum();
+        return 0;
+    }
+#endif
+
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < MATRIX_ROWS; current_row++) {
@@ -218,7 +302,17 @@ uint8_t matrix_scan(void) {
     }
 #endif
 
+    SCAN_PROFILE_START(debounce_start);
     debounce(raw_matrix, matrix, MATRIX_ROWS, changed);
+    SCAN_PROFILE_END(SCAN_PROFILE_DEBOUNCE, debounce_start);
+
+#ifdef MATRIX_WAKE_ENABLE
+    bool keys_down = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        keys_down |= (raw_matrix[row] | matrix[row]) != 0;
+    }
+    matrix_wake_update(keys_down);
+#endif
 
     matrix_scan_quantum();
     return (uint8_t)changed;
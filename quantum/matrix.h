@@ -19,6 +19,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdint.h>
 #include <stdbool.h>
+#ifdef MATRIX_IO_DELAY_CALIBRATE
+#    include "gpio.h"
+#endif
 
 #if (MATRIX_COLS <= 8)
 typedef uint8_t matrix_row_t;
@@ -59,6 +62,12 @@ void matrix_output_select_delay(void);
 void matrix_output_unselect_delay(void);
 /* only for backwards compatibility. delay between changing matrix pin state and reading values */
 void matrix_io_delay(void);
+#ifdef MATRIX_IO_DELAY_CALIBRATE
+/* measure how long the given input pins take to rise, and shorten matrix_output_unselect_delay() to match */
+void matrix_io_delay_calibrate(const pin_t pins[], uint8_t count);
+/* print the calibration result */
+void matrix_io_delay_report(void);
+#endif
 
 /* power control */
 void matrix_power_up(void);
@@ -9,6 +9,17 @@
 #    define MATRIX_IO_DELAY 30
 #endif
 
+#ifdef MATRIX_IO_DELAY_CALIBRATE
+// Samples taken per input pin, the slowest one wins
+#    ifndef MATRIX_IO_DELAY_CALIBRATE_SAMPLES
+#        define MATRIX_IO_DELAY_CALIBRATE_SAMPLES 8
+#    endif
+// Guard band, in percent of the measured settle time
+#    ifndef MATRIX_IO_DELAY_CALIBRATE_GUARD
+#        define MATRIX_IO_DELAY_CALIBRATE_GUARD 200
+#    endif
+#endif
+
 /* matrix state(1:on, 0:off) */
 matrix_row_t raw_matrix[MATRIX_ROWS];
 matrix_row_t matrix[MATRIX_ROWS];
@@ -88,7 +99,110 @@ uint8_t matrix_key_count(void) {
 __attribute__((weak)) void matrix_io_delay(void) { wait_us(MATRIX_IO_DELAY); }
 
 __attribute__((weak)) void matrix_output_select_delay(void) { waitInputPinDelay(); }
-__attribute__((weak)) void matrix_output_unselect_delay(void) { matrix_io_delay(); }
+
+#ifdef MATRIX_IO_DELAY_CALIBRATE
+static pin_t    settle_pin           = NO_PIN;
+static uint16_t settle_polls         = 0;  // slowest rise seen, in pin reads
+static uint16_t unselect_delay_polls = 0;  // 0 while the fixed delay is used
+static uint32_t polls_per_ms         = 0;
+
+// Calibration runs for at least this long, so the millisecond timer is a small error
+#    define MATRIX_IO_DELAY_CALIBRATE_MS 8
+
+static inline uint16_t polls_to_us(uint16_t polls) { return polls_per_ms ? ((uint32_t)polls * 1000 + polls_per_ms - 1) / polls_per_ms : 0; }
+
+/** \brief Reads a pin a number of times, the unit of the calibrated delay
+ *
+ * Used both to time the reads and as the delay, so they match.
+ */
+static void read_pin_times(pin_t pin, uint32_t reads) {
+    for (uint32_t i = 0; i < reads; i++) {
+        (void)readPin(pin);
+    }
+}
+
+/** \brief Calibrates the unselect delay against the real input lines
+ *
+ * Each input is pulled low as an output, to discharge the line, then let go
+ * with its pull-up on. The number of pin reads until it reads high again is
+ * the time an unselected row (or column) takes to release it. The slowest
+ * pin, plus the guard band, becomes the delay, counted in the same pin reads.
+ * The fixed MATRIX_IO_DELAY stays in use if the lines are slower than that.
+ */
+void matrix_io_delay_calibrate(const pin_t pins[], uint8_t count) {
+    settle_pin           = NO_PIN;
+    settle_polls         = 0;
+    unselect_delay_polls = 0;
+
+    for (uint8_t i = 0; i < count && settle_pin == NO_PIN; i++) {
+        settle_pin = pins[i];
+    }
+    if (settle_pin == NO_PIN) return;
+
+    // Pin reads per millisecond, to bound the measurement and report it in
+    // microseconds: time more and more reads until they take long enough
+    uint32_t reads   = 256;
+    uint32_t elapsed = 0;
+    for (;;) {
+        uint32_t start = timer_read32();
+        while (timer_read32() == start) {
+        }
+        start = timer_read32();
+        read_pin_times(settle_pin, reads);
+        elapsed = TIMER_DIFF_32(timer_read32(), start);
+        if (elapsed >= MATRIX_IO_DELAY_CALIBRATE_MS || reads >= UINT32_MAX / 2) break;
+        reads *= 2;
+    }
+    polls_per_ms = reads / (elapsed ? elapsed : 1);
+
+    uint32_t limit = polls_per_ms * MATRIX_IO_DELAY / 1000;
+    if (limit > UINT16_MAX) limit = UINT16_MAX;
+
+    for (uint8_t i = 0; i < count; i++) {
+        pin_t pin = pins[i];
+        if (pin == NO_PIN) continue;
+
+        for (uint8_t sample = 0; sample < MATRIX_IO_DELAY_CALIBRATE_SAMPLES; sample++) {
+            uint16_t polls = 0;
+            ATOMIC_BLOCK_FORCEON {
+                setPinOutput(pin);
+                writePinLow(pin);
+                waitInputPinDelay();
+                setPinInputHigh(pin);
+                while (!readPin(pin) && polls < limit) {
+                    polls++;
+                }
+            }
+            if (polls > settle_polls) settle_polls = polls;
+        }
+    }
+
+    uint32_t delay = (uint32_t)settle_polls * MATRIX_IO_DELAY_CALIBRATE_GUARD / 100 + 1;
+    if (settle_polls < limit && delay < limit) {
+        unselect_delay_polls = delay;
+    }
+}
+
+/** \brief Prints the calibration result, from the Command status key
+ */
+void matrix_io_delay_report(void) {
+    if (unselect_delay_polls) {
+        xprintf("matrix: inputs settle in %u reads (~%uus), unselect delay %u reads (~%uus), was %uus\n", settle_polls, polls_to_us(settle_polls), unselect_delay_polls, polls_to_us(unselect_delay_polls), MATRIX_IO_DELAY);
+    } else {
+        xprintf("matrix: inputs settle slower than %uus, keeping the fixed unselect delay\n", MATRIX_IO_DELAY);
+    }
+}
+#endif
+
+__attribute__((weak)) void matrix_output_unselect_delay(void) {
+#ifdef MATRIX_IO_DELAY_CALIBRATE
+    if (unselect_delay_polls) {
+        read_pin_times(settle_pin, unselect_delay_polls);
+        return;
+    }
+#endif
+    matrix_io_delay();
+}
 
 // CUSTOM MATRIX 'LITE'
 __attribute__((weak)) void matrix_init_custom(void) {}
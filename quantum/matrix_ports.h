@@ -0,0 +1,95 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/* Port-grouped column reads, for the matrix scanners.
+ *
+ * Instead of one readPin() per column, each GPIO port holding a column is
+ * read once, and its bits are moved into place. Columns that sit on a port in
+ * the same order as in the matrix (PB0..PB7 for columns 3..10, say) are moved
+ * with a single shift; the others are picked out one by one.
+ *
+ * The grouping is worked out once by matrix_ports_init(), after the column
+ * pins are final (split keyboards may swap them for the right hand).
+ */
+
+#include <stddef.h>
+#include "matrix.h"
+#include "gpio.h"
+
+typedef struct {
+    pin_t        pin;    // any pin on the port, to read it
+    port_data_t  mask;   // bits of the columns on this port
+    matrix_row_t cols;   // the same columns, in the matrix row
+    int8_t       shift;  // cols = mask << shift, when linear
+    bool         linear;
+} matrix_port_t;
+
+static matrix_port_t matrix_ports[MATRIX_COLS];
+static uint8_t       matrix_port_count;
+
+static inline void matrix_ports_init(const pin_t pins[]) {
+    matrix_port_count = 0;
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        matrix_port_t *port = NULL;
+        for (uint8_t i = 0; i < matrix_port_count; i++) {
+            if (samePort(matrix_ports[i].pin, pins[col])) {
+                port = &matrix_ports[i];
+                break;
+            }
+        }
+
+        port_data_t bit = pinPortMask(pins[col]);
+        int8_t      pad = 0;
+        while (!(bit & ((port_data_t)1 << pad))) pad++;
+
+        if (!port) {
+            port         = &matrix_ports[matrix_port_count++];
+            port->pin    = pins[col];
+            port->mask   = 0;
+            port->cols   = 0;
+            port->shift  = col - pad;
+            port->linear = true;
+        } else if (port->shift != col - pad) {
+            port->linear = false;
+        }
+        port->mask |= bit;
+        port->cols |= MATRIX_ROW_SHIFTER << col;
+    }
+}
+
+/** \brief Columns reading low, as a matrix row
+ */
+static inline matrix_row_t matrix_ports_read_low(const pin_t pins[]) {
+    matrix_row_t row = 0;
+
+    for (uint8_t i = 0; i < matrix_port_count; i++) {
+        const matrix_port_t *port = &matrix_ports[i];
+        port_data_t          low  = ~readPort(port->pin) & port->mask;
+
+        if (port->linear) {
+            row |= port->shift >= 0 ? (matrix_row_t)low << port->shift : (matrix_row_t)(low >> -port->shift);
+        } else {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                if ((port->cols & (MATRIX_ROW_SHIFTER << col)) && (low & pinPortMask(pins[col]))) {
+                    row |= MATRIX_ROW_SHIFTER << col;
+                }
+            }
+        }
+    }
+    return row;
+}
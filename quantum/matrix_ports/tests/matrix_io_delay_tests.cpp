@@ -0,0 +1,167 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "matrix.h"
+#include "timer.h"
+#include "print.h"
+
+int8_t sendchar(uint8_t c);
+
+port_data_t test_gpio_ports[16];
+}
+
+// A fake clock that moves one microsecond per pin or timer read
+static uint32_t now_us;
+static uint32_t pin_reads;
+static uint32_t waits;
+
+// What the report prints
+static std::string printed;
+
+static int8_t print_to_string(uint8_t c) {
+    printed += c;
+    return 0;
+}
+
+// Reads each pin stays low for once it is let go, and the line rising now
+static uint16_t rise_reads[2];
+static pin_t    rising_pin;
+static uint16_t rising;
+
+static const pin_t pins[2] = {TEST_PIN(1, 0), TEST_PIN(2, 3)};
+
+extern "C" {
+port_data_t test_gpio_read_port(uint8_t port) {
+    now_us++;
+    pin_reads++;
+    port_data_t value = test_gpio_ports[port];
+    if (rising && port == rising_pin >> 4) {
+        rising--;
+        value &= ~pinPortMask(rising_pin);
+    }
+    return value;
+}
+
+void setPinOutput(pin_t pin) {}
+
+void writePinLow(pin_t pin) {}
+
+void setPinInputHigh(pin_t pin) {
+    rising_pin = pin;
+    rising     = rise_reads[pin == pins[0] ? 0 : 1];
+}
+
+uint32_t timer_read32(void) { return now_us++ / 1000; }
+
+void wait_ms(uint32_t ms) { waits++; }
+
+// The rest of the matrix, not under test
+bool debounce_active(void) { return false; }
+
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {}
+
+void matrix_init_quantum(void) {}
+
+void matrix_scan_quantum(void) {}
+}
+
+class MatrixIoDelay : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        for (auto &port : test_gpio_ports) port = 0xFF;
+        now_us = 0;
+    }
+
+    // Reads and waits taken by one unselect delay
+    void unselect_delay() {
+        pin_reads = 0;
+        waits     = 0;
+        matrix_output_unselect_delay();
+    }
+
+    std::string report() {
+        printed.clear();
+        print_set_sendchar(print_to_string);
+        matrix_io_delay_report();
+        print_set_sendchar(sendchar);
+        return printed;
+    }
+};
+
+TEST_F(MatrixIoDelay, TheSlowestPinSetsTheDelay) {
+    rise_reads[0] = 60;
+    rise_reads[1] = 100;
+    matrix_io_delay_calibrate(pins, 2);
+
+    // 100 reads plus the 200% guard band
+    unselect_delay();
+    EXPECT_EQ(pin_reads, 201);
+    EXPECT_EQ(waits, 0);
+}
+
+TEST_F(MatrixIoDelay, TheReportIsInMicroseconds) {
+    rise_reads[0] = 100;
+    rise_reads[1] = 0;
+    matrix_io_delay_calibrate(pins, 2);
+
+    // 8192 reads time to 8 ms, 1024 reads per ms, so 100 reads round up to 98us
+    EXPECT_EQ(report(), "matrix: inputs settle in 100 reads (~98us), unselect delay 201 reads (~197us), was 300us\n");
+}
+
+TEST_F(MatrixIoDelay, MissingPinsAreSkipped) {
+    const pin_t some_pins[3] = {NO_PIN, pins[0], NO_PIN};
+    rise_reads[0]            = 10;
+    matrix_io_delay_calibrate(some_pins, 3);
+
+    unselect_delay();
+    EXPECT_EQ(pin_reads, 21);
+}
+
+TEST_F(MatrixIoDelay, LinesSlowerThanTheFixedDelayKeepIt) {
+    // 300us is 307 reads, the 200 reads needed with the guard band would be 401
+    rise_reads[0] = 10;
+    rise_reads[1] = 200;
+    matrix_io_delay_calibrate(pins, 2);
+
+    unselect_delay();
+    EXPECT_EQ(pin_reads, 0);
+    EXPECT_EQ(waits, 1);
+    EXPECT_EQ(report(), "matrix: inputs settle slower than 300us, keeping the fixed unselect delay\n");
+}
+
+TEST_F(MatrixIoDelay, ALineThatNeverRisesStopsAtTheLimit) {
+    rise_reads[0] = 10;
+    rise_reads[1] = 60000;
+    matrix_io_delay_calibrate(pins, 2);
+
+    unselect_delay();
+    EXPECT_EQ(pin_reads, 0);
+    EXPECT_EQ(waits, 1);
+}
+
+TEST_F(MatrixIoDelay, NoPinsKeepTheFixedDelay) {
+    const pin_t no_pins[2] = {NO_PIN, NO_PIN};
+    matrix_io_delay_calibrate(no_pins, 2);
+
+    unselect_delay();
+    EXPECT_EQ(pin_reads, 0);
+    EXPECT_EQ(waits, 1);
+}
@@ -0,0 +1,138 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "matrix_ports.h"
+
+port_data_t test_gpio_ports[16];
+
+port_data_t test_gpio_read_port(uint8_t port) { return test_gpio_ports[port]; }
+}
+
+class MatrixPorts : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        for (auto &port : test_gpio_ports) port = 0xFF;
+    }
+
+    // What read_cols_on_row() computes without MATRIX_PORT_GROUPED_READ
+    matrix_row_t read_pin_by_pin(const pin_t pins[]) {
+        matrix_row_t row = 0;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (!readPin(pins[col])) row |= MATRIX_ROW_SHIFTER << col;
+        }
+        return row;
+    }
+
+    // Every combination of pressed columns one port value at a time, plus a pseudo-random walk
+    void expect_same_as_pin_by_pin(const pin_t pins[]) {
+        for (uint8_t port = 0; port < 16; port++) {
+            for (unsigned value = 0; value < 256; value++) {
+                SetUp();
+                test_gpio_ports[port] = value;
+                ASSERT_EQ(matrix_ports_read_low(pins), read_pin_by_pin(pins)) << "port " << +port << " value " << value;
+            }
+        }
+        uint32_t seed = 1;
+        for (int i = 0; i < 1000; i++) {
+            for (auto &port : test_gpio_ports) {
+                seed = seed * 1103515245 + 12345;
+                port = seed >> 16;
+            }
+            ASSERT_EQ(matrix_ports_read_low(pins), read_pin_by_pin(pins));
+        }
+    }
+};
+
+TEST_F(MatrixPorts, LinearPortsAreShiftedLeft) {
+    // Columns 0..3 on port 2 bits 0..3, columns 4..11 on port 3 bits 0..7
+    const pin_t pins[MATRIX_COLS] = {TEST_PIN(2, 0), TEST_PIN(2, 1), TEST_PIN(2, 2), TEST_PIN(2, 3), TEST_PIN(3, 0), TEST_PIN(3, 1), TEST_PIN(3, 2), TEST_PIN(3, 3), TEST_PIN(3, 4), TEST_PIN(3, 5), TEST_PIN(3, 6), TEST_PIN(3, 7)};
+    matrix_ports_init(pins);
+
+    ASSERT_EQ(matrix_port_count, 2);
+    EXPECT_TRUE(matrix_ports[0].linear);
+    EXPECT_EQ(matrix_ports[0].shift, 0);
+    EXPECT_EQ(matrix_ports[0].mask, 0x0F);
+    EXPECT_TRUE(matrix_ports[1].linear);
+    EXPECT_EQ(matrix_ports[1].shift, 4);
+    EXPECT_EQ(matrix_ports[1].mask, 0xFF);
+
+    test_gpio_ports[2] = 0xF0 | 0x0A;  // columns 0 and 2 low, the unused bits high
+    test_gpio_ports[3] = 0x7F;         // column 11 low
+    EXPECT_EQ(matrix_ports_read_low(pins), 0x0805);
+
+    // Unused bits of a port don't show up in the row
+    test_gpio_ports[2] = 0x0F;
+    test_gpio_ports[3] = 0xFF;
+    EXPECT_EQ(matrix_ports_read_low(pins), 0);
+
+    expect_same_as_pin_by_pin(pins);
+}
+
+TEST_F(MatrixPorts, LinearPortsAreShiftedRight) {
+    // Columns 0..3 on port 1 bits 4..7, the rest on port 0 bits 0..7
+    const pin_t pins[MATRIX_COLS] = {TEST_PIN(1, 4), TEST_PIN(1, 5), TEST_PIN(1, 6), TEST_PIN(1, 7), TEST_PIN(0, 0), TEST_PIN(0, 1), TEST_PIN(0, 2), TEST_PIN(0, 3), TEST_PIN(0, 4), TEST_PIN(0, 5), TEST_PIN(0, 6), TEST_PIN(0, 7)};
+    matrix_ports_init(pins);
+
+    ASSERT_EQ(matrix_port_count, 2);
+    EXPECT_TRUE(matrix_ports[0].linear);
+    EXPECT_EQ(matrix_ports[0].shift, -4);
+
+    test_gpio_ports[1] = 0x7F;  // column 3 low
+    EXPECT_EQ(matrix_ports_read_low(pins), 0x0008);
+
+    expect_same_as_pin_by_pin(pins);
+}
+
+TEST_F(MatrixPorts, GapsKeepAPortLinear) {
+    // Columns 0 and 5 on port 4 bits 0 and 5, same shift with unused bits in between
+    const pin_t pins[MATRIX_COLS] = {TEST_PIN(4, 0), TEST_PIN(5, 0), TEST_PIN(5, 1), TEST_PIN(5, 2), TEST_PIN(5, 3), TEST_PIN(4, 5), TEST_PIN(6, 0), TEST_PIN(6, 1), TEST_PIN(6, 2), TEST_PIN(6, 3), TEST_PIN(6, 4), TEST_PIN(6, 5)};
+    matrix_ports_init(pins);
+
+    ASSERT_EQ(matrix_port_count, 3);
+    EXPECT_TRUE(matrix_ports[0].linear);
+    EXPECT_EQ(matrix_ports[0].mask, 0x21);
+    EXPECT_TRUE(matrix_ports[1].linear);
+
+    expect_same_as_pin_by_pin(pins);
+}
+
+TEST_F(MatrixPorts, OutOfOrderPinsArePickedOneByOne) {
+    // Port 7 holds columns 0..3 backwards and column 11, port 8 the rest in order
+    const pin_t pins[MATRIX_COLS] = {TEST_PIN(7, 3), TEST_PIN(7, 2), TEST_PIN(7, 1), TEST_PIN(7, 0), TEST_PIN(8, 0), TEST_PIN(8, 1), TEST_PIN(8, 2), TEST_PIN(8, 3), TEST_PIN(8, 4), TEST_PIN(8, 5), TEST_PIN(8, 6), TEST_PIN(7, 7)};
+    matrix_ports_init(pins);
+
+    ASSERT_EQ(matrix_port_count, 2);
+    EXPECT_FALSE(matrix_ports[0].linear);
+    EXPECT_EQ(matrix_ports[0].mask, 0x8F);
+    EXPECT_TRUE(matrix_ports[1].linear);
+
+    test_gpio_ports[7] = 0x7E;  // bit 0 (column 3) and bit 7 (column 11) low
+    EXPECT_EQ(matrix_ports_read_low(pins), 0x0808);
+
+    expect_same_as_pin_by_pin(pins);
+}
+
+TEST_F(MatrixPorts, OnePortPerColumn) {
+    pin_t pins[MATRIX_COLS];
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) pins[col] = TEST_PIN(col, 7 - (col % 8));
+    matrix_ports_init(pins);
+
+    EXPECT_EQ(matrix_port_count, MATRIX_COLS);
+    expect_same_as_pin_by_pin(pins);
+}
@@ -0,0 +1,33 @@
+# Copyright 2021 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# matrix_ports.h against the fake ports of the test gpio.h, 12 columns over several ports
+matrix_ports_DEFS := -DNO_DEBUG -DMATRIX_ROWS=1 -DMATRIX_COLS=12
+
+matrix_ports_INC := $(QUANTUM_PATH)
+
+matrix_ports_SRC := \
+	$(QUANTUM_PATH)/matrix_ports/tests/matrix_ports_tests.cpp
+
+# matrix_io_delay_calibrate() from matrix_common.c, timing fake lines that rise a number of pin reads after
+# they are let go, one read per microsecond
+matrix_io_delay_DEFS := -DMATRIX_ROWS=1 -DMATRIX_COLS=2 -DMATRIX_IO_DELAY=300 -DMATRIX_IO_DELAY_CALIBRATE -DIGNORE_ATOMIC_BLOCK
+
+matrix_io_delay_INC := $(QUANTUM_PATH)
+
+matrix_io_delay_SRC := \
+	$(QUANTUM_PATH)/matrix_ports/tests/matrix_io_delay_tests.cpp \
+	$(QUANTUM_PATH)/matrix_common.c \
+	$(QUANTUM_PATH)/bitwise.c
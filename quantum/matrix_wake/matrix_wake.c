@@ -0,0 +1,112 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "matrix_wake.h"
+#include "keyboard.h"
+#include "suspend.h"
+#include "timer.h"
+
+static volatile bool edge_seen = false;
+static bool          armed     = false;
+static uint32_t      last_keys_down_time;
+
+static void matrix_wake_resume(void) {
+    matrix_wake_disarm_pins();
+    armed               = false;
+    edge_seen           = false;
+    last_keys_down_time = timer_read32();
+    last_matrix_activity_trigger();
+}
+
+void matrix_wake_init(void) {
+    armed               = false;
+    edge_seen           = false;
+    last_keys_down_time = timer_read32();
+}
+
+/** \brief Called by the scanner before scanning
+ *
+ * Returns true while the matrix is idle and the scan can be skipped.
+ */
+bool matrix_wake_idle(void) {
+    if (!armed) return false;
+
+    // The level is checked as well, in case the platform has no pin interrupts
+    if (!edge_seen && matrix_wake_inputs_idle()) {
+        matrix_wake_sleep();
+        if (!edge_seen && matrix_wake_inputs_idle()) {
+            return true;
+        }
+    }
+
+    matrix_wake_resume();
+    return false;
+}
+
+/** \brief Called by the scanner after a scan, with whether any key is (still) down
+ */
+void matrix_wake_update(bool keys_down) {
+    if (keys_down) {
+        last_keys_down_time = timer_read32();
+        return;
+    }
+    if (armed || timer_elapsed32(last_keys_down_time) < MATRIX_WAKE_IDLE_TIMEOUT) {
+        return;
+    }
+
+    edge_seen = false;
+    matrix_wake_arm_pins();
+    armed = true;
+    // A key pressed since the last scan has no edge left to report
+    if (!matrix_wake_inputs_idle()) {
+        matrix_wake_resume();
+    }
+}
+
+/** \brief Called from the input pin interrupt
+ */
+void matrix_wake_edge(void) { edge_seen = true; }
+
+bool matrix_wake_is_armed(void) { return armed; }
+
+#if defined(PROTOCOL_CHIBIOS) && defined(PAL_USE_CALLBACKS) && (PAL_USE_CALLBACKS == TRUE)
+static void matrix_wake_pin_callback(void *arg) { matrix_wake_edge(); }
+
+__attribute__((weak)) void matrix_wake_enable_interrupts(const pin_t pins[], uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (pins[i] != NO_PIN) {
+            palEnableLineEvent(pins[i], PAL_EVENT_MODE_FALLING_EDGE);
+            palSetLineCallback(pins[i], matrix_wake_pin_callback, NULL);
+        }
+    }
+}
+
+__attribute__((weak)) void matrix_wake_disable_interrupts(const pin_t pins[], uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (pins[i] != NO_PIN) {
+            palDisableLineEvent(pins[i]);
+        }
+    }
+}
+#else
+// No generic pin interrupts here, the inputs are polled after each sleep instead
+__attribute__((weak)) void matrix_wake_enable_interrupts(const pin_t pins[], uint8_t count) {}
+__attribute__((weak)) void matrix_wake_disable_interrupts(const pin_t pins[], uint8_t count) {}
+#endif
+
+/** \brief Sleeps until the next interrupt, or for a millisecond
+ */
+__attribute__((weak)) void matrix_wake_sleep(void) { suspend_idle(1); }
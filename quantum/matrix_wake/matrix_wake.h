@@ -0,0 +1,49 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+
+/* Wake on edge: stop scanning an idle matrix.
+ *
+ * Once no key has been down for MATRIX_WAKE_IDLE_TIMEOUT milliseconds, the
+ * scanner drives all its outputs active at once, so pressing any key pulls
+ * its input low. Scans are then skipped and the CPU sleeps, until an input
+ * pin interrupt fires or an input reads low, and full scanning resumes.
+ */
+
+#ifndef MATRIX_WAKE_IDLE_TIMEOUT
+#    define MATRIX_WAKE_IDLE_TIMEOUT 1000
+#endif
+
+void matrix_wake_init(void);
+bool matrix_wake_idle(void);
+void matrix_wake_update(bool keys_down);
+void matrix_wake_edge(void);
+bool matrix_wake_is_armed(void);
+
+// Implemented by the matrix scanner
+void matrix_wake_arm_pins(void);
+void matrix_wake_disarm_pins(void);
+bool matrix_wake_inputs_idle(void);
+
+// Implemented per platform, can be overridden by the keyboard
+void matrix_wake_enable_interrupts(const pin_t pins[], uint8_t count);
+void matrix_wake_disable_interrupts(const pin_t pins[], uint8_t count);
+void matrix_wake_sleep(void);
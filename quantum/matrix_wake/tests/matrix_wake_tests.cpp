@@ -0,0 +1,194 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "matrix_wake.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// A fake scanner: one key, and a pin interrupt that fires on press while armed
+static bool key_down;
+static bool interrupt_enabled;
+static bool interrupt_pending;
+static int  press_during_sleep;
+static int  arm_count;
+static int  disarm_count;
+static int  sleep_count;
+static int  activity_count;
+
+extern "C" {
+void matrix_wake_arm_pins(void) {
+    arm_count++;
+    interrupt_enabled = true;
+}
+
+void matrix_wake_disarm_pins(void) {
+    disarm_count++;
+    interrupt_enabled = false;
+}
+
+bool matrix_wake_inputs_idle(void) { return !key_down; }
+
+void last_matrix_activity_trigger(void) { activity_count++; }
+
+void suspend_idle(uint8_t time) {
+    sleep_count++;
+    advance_time(time);
+    if (press_during_sleep && --press_during_sleep == 0) {
+        key_down = true;
+        if (interrupt_enabled) interrupt_pending = true;
+    }
+    if (interrupt_pending) {
+        interrupt_pending = false;
+        matrix_wake_edge();
+    }
+}
+}
+
+class MatrixWake : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        key_down           = false;
+        interrupt_enabled  = false;
+        interrupt_pending  = false;
+        press_during_sleep = 0;
+        arm_count          = 0;
+        disarm_count       = 0;
+        sleep_count        = 0;
+        activity_count     = 0;
+        scan_count         = 0;
+        set_time(0);
+        matrix_wake_init();
+    }
+
+    // Mirrors matrix_scan(): returns false when the scan was skipped
+    bool scan(void) {
+        bool scanned = !matrix_wake_idle();
+        if (scanned) {
+            scan_count++;
+            matrix_wake_update(key_down);
+            advance_time(1);
+        }
+        return scanned;
+    }
+
+    void scan_for(uint32_t ms) {
+        uint32_t start = timer_read32();
+        while (timer_elapsed32(start) < ms) {
+            scan();
+        }
+    }
+
+    int scan_count;
+};
+
+TEST_F(MatrixWake, StaysAwakeWhileKeysDown) {
+    key_down = true;
+    scan_for(MATRIX_WAKE_IDLE_TIMEOUT * 3);
+    EXPECT_EQ(arm_count, 0);
+    EXPECT_FALSE(matrix_wake_is_armed());
+    EXPECT_EQ(sleep_count, 0);
+}
+
+TEST_F(MatrixWake, ArmsAfterIdleTimeout) {
+    scan_for(MATRIX_WAKE_IDLE_TIMEOUT - 1);
+    EXPECT_FALSE(matrix_wake_is_armed());
+
+    scan_for(2);
+    EXPECT_TRUE(matrix_wake_is_armed());
+    EXPECT_EQ(arm_count, 1);
+    EXPECT_EQ(disarm_count, 0);
+
+    int scans = scan_count;
+    for (int i = 0; i < 50; i++) {
+        EXPECT_FALSE(scan());
+    }
+    EXPECT_EQ(scan_count, scans);
+    EXPECT_EQ(sleep_count, 50);
+    EXPECT_EQ(arm_count, 1);
+}
+
+TEST_F(MatrixWake, WakesOnInterrupt) {
+    scan_for(MATRIX_WAKE_IDLE_TIMEOUT + 1);
+    ASSERT_TRUE(matrix_wake_is_armed());
+
+    press_during_sleep = 10;
+    for (int i = 0; i < 9; i++) {
+        EXPECT_FALSE(scan());
+    }
+    EXPECT_EQ(activity_count, 0);
+
+    // The key goes down while sleeping, the same scan call resumes scanning
+    EXPECT_TRUE(scan());
+    EXPECT_FALSE(matrix_wake_is_armed());
+    EXPECT_EQ(disarm_count, 1);
+    EXPECT_EQ(activity_count, 1);
+    EXPECT_FALSE(interrupt_enabled);
+}
+
+TEST_F(MatrixWake, WakesOnLevelWithoutInterrupt) {
+    scan_for(MATRIX_WAKE_IDLE_TIMEOUT + 1);
+    ASSERT_TRUE(matrix_wake_is_armed());
+
+    // Platforms without pin interrupts only see the input level
+    interrupt_enabled = false;
+    key_down          = true;
+    EXPECT_TRUE(scan());
+    EXPECT_FALSE(matrix_wake_is_armed());
+    EXPECT_EQ(sleep_count, 0);
+    EXPECT_EQ(activity_count, 1);
+}
+
+TEST_F(MatrixWake, KeyPressedWhileArming) {
+    scan_for(MATRIX_WAKE_IDLE_TIMEOUT - 1);
+
+    // Pressed after the last scan read it, so no edge will follow
+    key_down = true;
+    matrix_wake_update(false);
+    advance_time(1);
+    matrix_wake_update(false);
+    EXPECT_EQ(arm_count, 1);
+    EXPECT_EQ(disarm_count, 1);
+    EXPECT_FALSE(matrix_wake_is_armed());
+    EXPECT_EQ(activity_count, 1);
+    EXPECT_TRUE(scan());
+}
+
+TEST_F(MatrixWake, RearmsAfterRelease) {
+    scan_for(MATRIX_WAKE_IDLE_TIMEOUT + 1);
+    key_down = true;
+    EXPECT_TRUE(scan());
+
+    scan_for(20);
+    key_down = false;
+    scan_for(MATRIX_WAKE_IDLE_TIMEOUT - 1);
+    EXPECT_FALSE(matrix_wake_is_armed());
+    scan_for(2);
+    EXPECT_TRUE(matrix_wake_is_armed());
+    EXPECT_EQ(arm_count, 2);
+}
+
+TEST_F(MatrixWake, StaleEdgeIsIgnoredWhenArming) {
+    // An edge latched while scanning normally must not wake the next sleep
+    matrix_wake_edge();
+    scan_for(MATRIX_WAKE_IDLE_TIMEOUT + 1);
+    ASSERT_TRUE(matrix_wake_is_armed());
+    EXPECT_FALSE(scan());
+}
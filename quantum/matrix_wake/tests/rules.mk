@@ -0,0 +1,23 @@
+# Copyright 2021 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+matrix_wake_DEFS := -DNO_DEBUG -DMATRIX_WAKE_ENABLE -DMATRIX_WAKE_IDLE_TIMEOUT=100
+
+matrix_wake_INC := $(QUANTUM_PATH)/matrix_wake
+
+matrix_wake_SRC := \
+	$(QUANTUM_PATH)/matrix_wake/tests/matrix_wake_tests.cpp \
+	$(QUANTUM_PATH)/matrix_wake/matrix_wake.c \
+	$(TMK_PATH)/common/test/timer.c
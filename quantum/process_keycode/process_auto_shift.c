@@ -20,10 +20,12 @@
 #    include <stdio.h>
 
 #    include "process_auto_shift.h"
+#    include "latency_trace.h"
 
 static uint16_t autoshift_time    = 0;
 static uint16_t autoshift_timeout = AUTO_SHIFT_TIMEOUT;
 static uint16_t autoshift_lastkey = KC_NO;
+static keypos_t autoshift_lastpos;
 static struct {
     // Whether autoshift is enabled.
     bool enabled : 1;
@@ -73,8 +75,10 @@ static bool autoshift_press(uint16_t keycode, uint16_t now, keyrecord_t *record)
 
     // Record the keycode so we can simulate it later.
     autoshift_lastkey           = keycode;
+    autoshift_lastpos           = record->event.key;
     autoshift_time              = now;
     autoshift_flags.in_progress = true;
+    deadline_set(DEADLINE_AUTO_SHIFT, now + autoshift_timeout);
 
 #    if !defined(NO_ACTION_ONESHOT) && !defined(NO_ACTION_TAPPING)
     clear_oneshot_layer_state(ONESHOT_OTHER_KEY_PRESSED);
@@ -94,6 +98,8 @@ static void autoshift_end(uint16_t keycode, uint16_t now, bool matrix_trigger) {
     if (autoshift_flags.in_progress) {
         // Process the auto-shiftable key.
         autoshift_flags.in_progress = false;
+        deadline_clear(DEADLINE_AUTO_SHIFT);
+        latency_trace_source_begin(autoshift_lastpos, true, LATENCY_TRACE_AUTO_SHIFT);
 
         // Time since the initial press was recorded.
         const uint16_t elapsed = TIMER_DIFF_16(now, autoshift_time);
@@ -108,6 +114,7 @@ static void autoshift_end(uint16_t keycode, uint16_t now, bool matrix_trigger) {
 #    if defined(AUTO_SHIFT_REPEAT) && !defined(AUTO_SHIFT_NO_AUTO_REPEAT)
             if (matrix_trigger) {
                 // Prevents release.
+                latency_trace_source_end();
                 return;
             }
 #    endif
@@ -118,6 +125,8 @@ static void autoshift_end(uint16_t keycode, uint16_t now, bool matrix_trigger) {
 #    endif
         unregister_code(autoshift_lastkey);
         del_weak_mods(MOD_BIT(KC_LSFT));
+        send_keyboard_report();  // del_weak_mods doesn't send one.
+        latency_trace_source_end();
     } else {
         // Release after keyrepeat.
         unregister_code(keycode);
@@ -127,8 +136,8 @@ static void autoshift_end(uint16_t keycode, uint16_t now, bool matrix_trigger) {
             // later Bs (if B wasn't auto-shiftable).
             del_weak_mods(MOD_BIT(KC_LSFT));
         }
+        send_keyboard_report();  // del_weak_mods doesn't send one.
     }
-    send_keyboard_report();  // del_weak_mods doesn't send one.
     // Roll the autoshift_time forward for detecting tap-and-hold.
     autoshift_time = now;
 }
@@ -140,7 +149,7 @@ static void autoshift_end(uint16_t keycode, uint16_t now, bool matrix_trigger) {
  *  to be released.
  */
 void autoshift_matrix_scan(void) {
-    if (autoshift_flags.in_progress) {
+    if (deadline_passed(DEADLINE_AUTO_SHIFT)) {
         const uint16_t now     = timer_read();
         const uint16_t elapsed = TIMER_DIFF_16(now, autoshift_time);
         if (elapsed >= autoshift_timeout) {
@@ -175,7 +184,10 @@ bool get_autoshift_state(void) { return autoshift_flags.enabled; }
 
 uint16_t get_autoshift_timeout(void) { return autoshift_timeout; }
 
-void set_autoshift_timeout(uint16_t timeout) { autoshift_timeout = timeout; }
+void set_autoshift_timeout(uint16_t timeout) {
+    autoshift_timeout = timeout;
+    if (autoshift_flags.in_progress) deadline_set(DEADLINE_AUTO_SHIFT, autoshift_time + autoshift_timeout);
+}
 
 bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
     // Note that record->event.time isn't reliable, see:
@@ -14,31 +14,55 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include "print.h"
 #include "process_combo.h"
+#include "action_tapping.h"
+#include "latency_trace.h"
 
 #ifndef COMBO_VARIABLE_LEN
 __attribute__((weak)) combo_t key_combos[COMBO_COUNT] = {};
+#    define NUMBER_OF_COMBOS COMBO_COUNT
 #else
 extern combo_t  key_combos[];
 extern int      COMBO_LEN;
+#    define NUMBER_OF_COMBOS COMBO_LEN
 #endif
 
 __attribute__((weak)) void process_combo_event(uint16_t combo_index, bool pressed) {}
 
-static uint16_t timer               = 0;
-static uint16_t current_combo_index = 0;
-static bool     drop_buffer         = false;
-static bool     is_active           = false;
-static bool     b_combo_enable      = true;  // defaults to enabled
-
-static uint8_t buffer_size = 0;
-#ifdef COMBO_ALLOW_ACTION_KEYS
-static keyrecord_t key_buffer[MAX_COMBO_LENGTH];
+#ifdef COMBO_TERM_PER_COMBO
+__attribute__((weak)) uint16_t get_combo_term(uint16_t combo_index, combo_t *combo) { return COMBO_TERM; }
+#    define COMBO_TERM_OF(index) get_combo_term(index, &key_combos[index])
 #else
-static uint16_t key_buffer[MAX_COMBO_LENGTH];
+#    define COMBO_TERM_OF(index) COMBO_TERM
 #endif
 
+#ifdef COMBO_SHOULD_TRIGGER
+__attribute__((weak)) bool combo_should_trigger(uint16_t combo_index, combo_t *combo, uint16_t keycode, keyrecord_t *record) { return true; }
+#endif
+
+/* Key presses held back while they may still be part of a combo, with their
+ * original timestamps. Every buffered key belongs to each combo still
+ * possible, so the keys of a combo have to be pressed one after the other,
+ * without any other key in between.
+ */
+typedef struct {
+    keyrecord_t record;
+    uint16_t    keycode;
+} combo_buffered_key_t;
+
+static combo_buffered_key_t key_buffer[MAX_COMBO_LENGTH];
+static uint8_t              buffer_size = 0;
+
+/* While a tap-hold key is undecided, the layer the buffered keys come from
+ * is not known: they are only matched against the combos once it is.
+ */
+static bool combo_waits_for_tapping = false;
+
+static uint16_t current_combo_index = 0;
+static bool     b_combo_enable      = true;  // defaults to enabled
+
 static inline void send_combo(uint16_t action, bool pressed) {
     if (action) {
         if (pressed) {
@@ -51,155 +75,388 @@ static inline void send_combo(uint16_t action, bool pressed) {
     }
 }
 
-static inline void dump_key_buffer(bool emit) {
-    if (buffer_size == 0) {
-        return;
-    }
+// Event times are odd, so is this, and it is never before the last event
+static inline uint16_t combo_now(void) { return timer_read() | 1; }
 
-    if (emit) {
-        for (uint8_t i = 0; i < buffer_size; i++) {
-#ifdef COMBO_ALLOW_ACTION_KEYS
-            const action_t action = store_or_get_action(key_buffer[i].event.pressed, key_buffer[i].event.key);
-            process_action(&(key_buffer[i]), action);
+static inline const keyrecord_t *combo_undecided_tapping_key(void) {
+#ifndef NO_ACTION_TAPPING
+    return get_undecided_tapping_key();
 #else
-            register_code16(key_buffer[i]);
-            send_keyboard_report();
+    return NULL;
 #endif
+}
+
+#define ALL_COMBO_KEYS(count) ((combo_state_t)(((combo_state_t)2 << ((count)-1)) - 1))
+
+/* The bit of keycode among the keys of the combo, 0 if the combo does not
+ * use it. count gets the number of keys of the combo.
+ */
+static combo_state_t combo_key_bit(const combo_t *combo, uint16_t keycode, uint8_t *count) {
+    combo_state_t bit = 0;
+    uint8_t       i   = 0;
+    for (uint16_t key; COMBO_END != (key = pgm_read_word(&combo->keys[i])); i++) {
+        if (keycode == key) bit = (combo_state_t)1 << i;
+    }
+    *count = i;
+    return bit;
+}
+
+#ifdef COMBO_INDEX
+/* Inverted index from keycode to the combos using it, built from key_combos
+ * on the first event, so an event only goes through the combos it can
+ * affect. Sorted by keycode, then combo, so combos are processed in the
+ * same order as without the index.
+ */
+typedef struct {
+    uint16_t keycode;
+    uint16_t combo_index;
+} combo_index_entry_t;
+
+static combo_index_entry_t combo_index[COMBO_INDEX_SIZE];
+static uint16_t            combo_index_count = 0;
+static int                 combo_index_len   = -1;  // combos the index was built for
+static bool                combo_index_valid = false;
+
+static void combo_index_build(void) {
+    combo_index_len   = NUMBER_OF_COMBOS;
+    combo_index_count = 0;
+    combo_index_valid = false;
+
+    for (uint16_t i = 0; i < combo_index_len; i++) {
+        for (const uint16_t *keys = key_combos[i].keys;; ++keys) {
+            uint16_t key = pgm_read_word(keys);
+            if (COMBO_END == key) break;
+
+            uint16_t j = combo_index_count;
+            while (j > 0 && combo_index[j - 1].keycode > key) j--;
+            // a key listed twice in the same combo
+            if (j > 0 && combo_index[j - 1].keycode == key && combo_index[j - 1].combo_index == i) continue;
+
+            if (combo_index_count == COMBO_INDEX_SIZE) {
+                dprintf("combo: more combo keys than COMBO_INDEX_SIZE, not using the index\n");
+                return;
+            }
+            memmove(&combo_index[j + 1], &combo_index[j], (combo_index_count - j) * sizeof(combo_index_entry_t));
+            combo_index[j] = (combo_index_entry_t){.keycode = key, .combo_index = i};
+            combo_index_count++;
+        }
+    }
+    combo_index_valid = true;
+}
+
+// The first entry for keycode, or where it would be
+static uint16_t combo_index_find(uint16_t keycode) {
+    uint16_t first = 0;
+    uint16_t last  = combo_index_count;
+    while (first < last) {
+        uint16_t middle = first + (last - first) / 2;
+        if (combo_index[middle].keycode < keycode) {
+            first = middle + 1;
+        } else {
+            last = middle;
         }
     }
+    return first;
+}
+#endif
 
-    buffer_size = 0;
+/* The combos that may use keycode are combo_at(i) for i in [*first, *last):
+ * those of the index, or all of them without it.
+ */
+static void combo_range(uint16_t keycode, uint16_t *first, uint16_t *last) {
+#ifdef COMBO_INDEX
+    if (combo_index_len != NUMBER_OF_COMBOS) combo_index_build();
+    if (combo_index_valid) {
+        *first = *last = combo_index_find(keycode);
+        while (*last < combo_index_count && combo_index[*last].keycode == keycode) (*last)++;
+        return;
+    }
+#endif
+    *first = 0;
+    *last  = NUMBER_OF_COMBOS;
 }
 
-#define ALL_COMBO_KEYS_ARE_DOWN (((1 << count) - 1) == combo->state)
-#define KEY_STATE_DOWN(key)         \
-    do {                            \
-        combo->state |= (1 << key); \
-    } while (0)
-#define KEY_STATE_UP(key)            \
-    do {                             \
-        combo->state &= ~(1 << key); \
-    } while (0)
+static inline uint16_t combo_at(uint16_t i) {
+#ifdef COMBO_INDEX
+    if (combo_index_valid) return combo_index[i].combo_index;
+#endif
+    return i;
+}
 
-static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record) {
-    uint8_t  count = 0;
-    uint16_t index = -1;
-    /* Find index of keycode and number of combo keys */
-    for (const uint16_t *keys = combo->keys;; ++count) {
-        uint16_t key = pgm_read_word(&keys[count]);
-        if (keycode == key) index = count;
-        if (COMBO_END == key) break;
+/* Whether the first size buffered keys are all keys of the combo, pressed
+ * within its term. matched gets their bits, count the number of keys of
+ * the combo.
+ */
+static bool combo_is_candidate(uint16_t index, uint8_t size, combo_state_t *matched, uint8_t *count) {
+    combo_t *combo = &key_combos[index];
+    // still held from the last time it fired
+    if (combo->state) return false;
+
+    *matched = 0;
+    for (uint8_t i = 0; i < size; i++) {
+        combo_state_t bit = combo_key_bit(combo, key_buffer[i].keycode, count);
+        if (!bit || (*matched & bit)) return false;
+        *matched |= bit;
     }
+    if (TIMER_DIFF_16(key_buffer[size - 1].record.event.time, key_buffer[0].record.event.time) >= COMBO_TERM_OF(index)) return false;
+#ifdef COMBO_SHOULD_TRIGGER
+    if (!combo_should_trigger(index, combo, key_buffer[0].keycode, &key_buffer[0].record)) return false;
+#endif
+    return true;
+}
 
-    /* Continue processing if not a combo key */
-    if (-1 == (int8_t)index) return false;
+// Fires a combo made of the first size buffered keys, the last of which completed it
+static void combo_fire(uint16_t index, combo_state_t keys, uint8_t size) {
+    key_combos[index].state = keys;
+    current_combo_index     = index;
+    latency_trace_source_begin(key_buffer[size - 1].record.event.key, true, LATENCY_TRACE_COMBO);
+    send_combo(key_combos[index].keycode, true);
+    latency_trace_source_end();
+}
 
-    bool is_combo_active = is_active;
+// Hands a held back key to the rest of the firmware, as if it was just pressed
+static void combo_replay_record(keyrecord_t *record) {
+    latency_trace_source_begin(record->event.key, true, LATENCY_TRACE_COMBO);
+#ifndef NO_ACTION_TAPPING
+    action_tapping_process(*record);
+#else
+    process_record(record);
+#endif
+    latency_trace_source_end();
+}
 
-    if (record->event.pressed) {
-        KEY_STATE_DOWN(index);
+// Hands the buffered keys from first on to the rest of the firmware
+static void combo_replay(uint8_t first) {
+    uint8_t size            = buffer_size;
+    buffer_size             = 0;
+    combo_waits_for_tapping = false;
+    for (uint8_t i = first; i < size; i++) {
+        combo_replay_record(&key_buffer[i].record);
+    }
+}
 
-        if (is_combo_active) {
-            if (ALL_COMBO_KEYS_ARE_DOWN) { /* Combo was pressed */
-                send_combo(combo->keycode, true);
-                drop_buffer = true;
+/* Ends the wait: fires the longest combo made of the first buffered keys,
+ * if there is one, and replays the keys it did not use. Keys still waiting
+ * for a tap-hold key are replayed as they are.
+ */
+static void combo_resolve(void) {
+    for (uint8_t size = combo_waits_for_tapping ? 0 : buffer_size; size > 0; size--) {
+        uint16_t first, last;
+        combo_range(key_buffer[0].keycode, &first, &last);
+        for (uint16_t i = first; i < last; i++) {
+            combo_state_t matched;
+            uint8_t       count;
+            if (combo_is_candidate(combo_at(i), size, &matched, &count) && count == size) {
+                combo_fire(combo_at(i), matched, size);
+                combo_replay(size);
+                return;
             }
         }
-    } else {
-        if (ALL_COMBO_KEYS_ARE_DOWN) { /* Combo was released */
-            send_combo(combo->keycode, false);
-        } else {
-            /* continue processing without immediately returning */
-            is_combo_active = false;
+    }
+    combo_replay(0);
+}
+
+/* Looks at the buffered keys: returns false if no combo can use them
+ * anymore. Otherwise a complete combo fires right away, unless a longer
+ * combo could still complete.
+ */
+static bool combo_check(void) {
+    uint16_t      first, last;
+    int32_t       complete  = -1;
+    combo_state_t completed = 0;
+    bool          longer    = false;
+
+    combo_range(key_buffer[0].keycode, &first, &last);
+    for (uint16_t i = first; i < last; i++) {
+        combo_state_t matched;
+        uint8_t       count;
+        if (!combo_is_candidate(combo_at(i), buffer_size, &matched, &count)) continue;
+        if (count > buffer_size) {
+            longer = true;
+        } else if (complete < 0) {
+            complete  = combo_at(i);
+            completed = matched;
         }
+    }
+
+    if (complete < 0 && !longer) return false;
+    if (complete >= 0 && !longer) {
+        combo_fire(complete, completed, buffer_size);
+        buffer_size = 0;
+    }
+    return true;
+}
 
-        KEY_STATE_UP(index);
+/* Arms the deadline for when the buffered keys stop waiting: the end of
+ * the latest term among the longer combos they could still complete.
+ */
+static void combo_set_deadline(void) {
+    if (buffer_size == 0) {
+        deadline_clear(DEADLINE_COMBO);
+        return;
+    }
+    // looks on every scan whether the tap-hold key got decided
+    if (combo_waits_for_tapping) {
+        deadline_set(DEADLINE_COMBO, combo_now());
+        return;
     }
 
-    return is_combo_active;
+    uint16_t now  = combo_now();
+    uint16_t wait = 0;
+    uint16_t first, last;
+    combo_range(key_buffer[0].keycode, &first, &last);
+    for (uint16_t i = first; i < last; i++) {
+        combo_state_t matched;
+        uint8_t       count;
+        if (!combo_is_candidate(combo_at(i), buffer_size, &matched, &count) || count <= buffer_size) continue;
+
+        uint16_t elapsed = TIMER_DIFF_16(now, key_buffer[0].record.event.time);
+        uint16_t term    = COMBO_TERM_OF(combo_at(i));
+        if (elapsed < term && term - elapsed > wait) wait = term - elapsed;
+    }
+    deadline_set(DEADLINE_COMBO, now + wait);
 }
 
-#define NO_COMBO_KEYS_ARE_DOWN (0 == combo->state)
+static bool combo_press(uint16_t keycode, keyrecord_t *record) {
+    if (buffer_size == MAX_COMBO_LENGTH) combo_resolve();
 
-bool process_combo(uint16_t keycode, keyrecord_t *record) {
-    bool is_combo_key          = false;
-    drop_buffer                = false;
-    bool no_combo_keys_pressed = true;
+    if (combo_undecided_tapping_key()) combo_waits_for_tapping = true;
+    key_buffer[buffer_size++] = (combo_buffered_key_t){.record = *record, .keycode = keycode};
+    if (combo_waits_for_tapping || combo_check()) return false;
 
-    if (keycode == CMB_ON && record->event.pressed) {
-        combo_enable();
-        return true;
+    // Not a combo key, or one breaking the combos started by the keys before it
+    buffer_size--;
+    if (buffer_size == 0) return true;
+    combo_resolve();
+    return combo_press(keycode, record);
+}
+
+static bool combo_release(uint16_t keycode, keyrecord_t *record) {
+    // Released before its combo completed: the combo is off
+    for (uint8_t i = 0; i < buffer_size; i++) {
+        if (KEYEQ(key_buffer[i].record.event.key, record->event.key)) {
+            combo_resolve();
+            break;
+        }
     }
 
-    if (keycode == CMB_OFF && record->event.pressed) {
-        combo_disable();
-        return true;
+    bool     is_combo_key = false;
+    uint16_t first, last;
+    combo_range(keycode, &first, &last);
+    for (uint16_t i = first; i < last; i++) {
+        combo_t *combo = &key_combos[combo_at(i)];
+        if (!combo->state) continue;
+
+        uint8_t       count;
+        combo_state_t bit = combo_key_bit(combo, keycode, &count);
+        if (!(bit & combo->state)) continue;
+
+        // The first key released releases the combo, the others are swallowed
+        if (combo->state == ALL_COMBO_KEYS(count)) {
+            current_combo_index = combo_at(i);
+            latency_trace_source_begin(record->event.key, false, LATENCY_TRACE_COMBO);
+            send_combo(combo->keycode, false);
+            latency_trace_source_end();
+        }
+        combo->state &= ~bit;
+        is_combo_key = true;
     }
 
-    if (keycode == CMB_TOG && record->event.pressed) {
-        combo_toggle();
-        return true;
+    /* Any other key goes up after the keys still held back, like Shift after
+     * a rolled letter, except for the undecided tap-hold key they wait for.
+     */
+    const keyrecord_t *tapping = combo_undecided_tapping_key();
+    if (!is_combo_key && buffer_size && !(combo_waits_for_tapping && tapping && KEYEQ(tapping->event.key, record->event.key))) combo_resolve();
+    return !is_combo_key;
+}
+
+/* Once the tap-hold key is decided, goes through the keys that waited for
+ * it again, with the keycodes of the layers now active, as if they were
+ * pressed just now. This also fixes the source layers of the keys a combo
+ * swallows, for their release.
+ */
+static bool combo_settle(void) {
+    if (!combo_waits_for_tapping || combo_undecided_tapping_key()) return false;
+
+    combo_buffered_key_t keys[MAX_COMBO_LENGTH];
+    uint8_t              size = buffer_size;
+    memcpy(keys, key_buffer, size * sizeof(combo_buffered_key_t));
+    buffer_size             = 0;
+    combo_waits_for_tapping = false;
+
+    for (uint8_t i = 0; i < size; i++) {
+        if (combo_press(get_event_keycode(keys[i].record.event, true), &keys[i].record)) {
+            combo_replay_record(&keys[i].record);
+        }
     }
+    combo_set_deadline();
+    return true;
+}
+
+/** \brief Holds back the key events that may be part of a combo
+ *
+ * Called by action_exec(), before tap-hold keys are resolved, so that
+ * buffered keys are replayed with the time they were pressed. Keys pressed
+ * while a tap-hold key is undecided wait for it, then are matched on the
+ * layers it leaves active.
+ */
+bool process_combo(uint16_t keycode, keyrecord_t *record) {
+    // the keys before this one may have changed the layers
+    if (combo_settle()) keycode = get_record_keycode(record, true);
 
-    if (!is_combo_enabled()) {
-        return true;
+    if (!record->event.pressed) {
+        bool pass = combo_release(keycode, record);
+        combo_set_deadline();
+        return pass;
     }
-#ifndef COMBO_VARIABLE_LEN
-    for (current_combo_index = 0; current_combo_index < COMBO_COUNT; ++current_combo_index) {
-#else
-    for (current_combo_index = 0; current_combo_index < COMBO_LEN; ++current_combo_index) {
-#endif
-        combo_t *combo = &key_combos[current_combo_index];
-        is_combo_key |= process_single_combo(combo, keycode, record);
-        no_combo_keys_pressed = no_combo_keys_pressed && NO_COMBO_KEYS_ARE_DOWN;
-    }
-
-    if (drop_buffer) {
-        /* buffer is only dropped when we complete a combo, so we refresh the timer
-         * here */
-        timer = timer_read();
-        dump_key_buffer(false);
-    } else if (!is_combo_key) {
-        /* if no combos claim the key we need to emit the keybuffer */
-        dump_key_buffer(true);
-
-        // reset state if there are no combo keys pressed at all
-        if (no_combo_keys_pressed) {
-            timer     = 0;
-            is_active = true;
-        }
-    } else if (record->event.pressed && is_active) {
-        /* otherwise the key is consumed and placed in the buffer */
-        timer = timer_read();
 
-        if (buffer_size < MAX_COMBO_LENGTH) {
-#ifdef COMBO_ALLOW_ACTION_KEYS
-            key_buffer[buffer_size++] = *record;
-#else
-            key_buffer[buffer_size++] = keycode;
-#endif
-        }
+    if (is_combo_enabled()) {
+        bool pass = combo_press(keycode, record);
+        combo_set_deadline();
+        if (!pass) return false;
     }
 
-    return !is_combo_key;
+    switch (keycode) {
+        case CMB_ON:
+            combo_enable();
+            break;
+        case CMB_OFF:
+            combo_disable();
+            break;
+        case CMB_TOG:
+            combo_toggle();
+            break;
+    }
+    return true;
 }
 
 void matrix_scan_combo(void) {
-    if (b_combo_enable && is_active && timer && timer_elapsed(timer) > COMBO_TERM) {
-        /* This disables the combo, meaning key events for this
-         * combo will be handled by the next processors in the chain
-         */
-        is_active = false;
-        dump_key_buffer(true);
+    if (buffer_size == 0 || !deadline_passed(DEADLINE_COMBO)) return;
+    if (combo_waits_for_tapping) {
+        combo_settle();
+        return;
+    }
+
+    // Keep waiting as long as a longer combo can still complete
+    uint16_t first, last;
+    combo_range(key_buffer[0].keycode, &first, &last);
+    for (uint16_t i = first; i < last; i++) {
+        combo_state_t matched;
+        uint8_t       count;
+        if (combo_is_candidate(combo_at(i), buffer_size, &matched, &count) && count > buffer_size && TIMER_DIFF_16(combo_now(), key_buffer[0].record.event.time) < COMBO_TERM_OF(combo_at(i))) {
+            combo_set_deadline();
+            return;
+        }
     }
+    combo_resolve();
+    combo_set_deadline();
 }
 
 void combo_enable(void) { b_combo_enable = true; }
 
 void combo_disable(void) {
-    b_combo_enable = is_active = false;
-    timer                      = 0;
-    dump_key_buffer(true);
+    b_combo_enable = false;
+    combo_replay(0);
 }
 
 void combo_toggle(void) {
@@ -28,16 +28,19 @@
 #    define MAX_COMBO_LENGTH 8
 #endif
 
-typedef struct {
-    const uint16_t *keys;
-    uint16_t        keycode;
+// One bit per key of a combo
 #ifdef EXTRA_EXTRA_LONG_COMBOS
-    uint32_t state;
+typedef uint32_t combo_state_t;
 #elif EXTRA_LONG_COMBOS
-    uint16_t state;
+typedef uint16_t combo_state_t;
 #else
-    uint8_t state;
+typedef uint8_t combo_state_t;
 #endif
+
+typedef struct {
+    const uint16_t *keys;
+    uint16_t        keycode;
+    combo_state_t   state;  // the keys still held since the combo fired
 } combo_t;
 
 #define COMBO(ck, ca) \
@@ -53,9 +56,19 @@ typedef struct {
 #    define COMBO_TERM TAPPING_TERM
 #endif
 
-bool process_combo(uint16_t keycode, keyrecord_t *record);
-void matrix_scan_combo(void);
-void process_combo_event(uint16_t combo_index, bool pressed);
+// Room in the keycode to combo index: every key of every combo takes an entry
+#if defined(COMBO_INDEX) && !defined(COMBO_INDEX_SIZE)
+#    ifdef COMBO_VARIABLE_LEN
+#        error "COMBO_INDEX with COMBO_VARIABLE_LEN needs COMBO_INDEX_SIZE"
+#    endif
+#    define COMBO_INDEX_SIZE (COMBO_COUNT * 3)
+#endif
+
+bool     process_combo(uint16_t keycode, keyrecord_t *record);
+void     matrix_scan_combo(void);
+void     process_combo_event(uint16_t combo_index, bool pressed);
+uint16_t get_combo_term(uint16_t combo_index, combo_t *combo);
+bool     combo_should_trigger(uint16_t combo_index, combo_t *combo, uint16_t keycode, keyrecord_t *record);
 
 void combo_enable(void);
 void combo_disable(void);
@@ -168,6 +168,7 @@ bool process_magic(uint16_t keycode, keyrecord_t *record) {
 
                 eeconfig_update_keymap(keymap_config.raw);
                 clear_keyboard();  // clear to prevent stuck keys
+                clear_resolved_action_cache();
 
                 return false;
         }
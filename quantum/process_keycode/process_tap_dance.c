@@ -14,12 +14,14 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "quantum.h"
+#include "latency_trace.h"
 
 #ifndef NO_ACTION_ONESHOT
 uint8_t get_oneshot_mods(void);
 #endif
 
 static uint16_t last_td;
+static keypos_t last_td_key;
 static int8_t   highest_td = -1;
 
 void qk_tap_dance_pair_on_each_tap(qk_tap_dance_state_t *state, void *user_data) {
@@ -102,6 +104,43 @@ static inline void process_tap_dance_action_on_reset(qk_tap_dance_action_t *acti
     send_keyboard_report();
 }
 
+static uint16_t tap_dance_term(qk_tap_dance_action_t *action) {
+    if (action->custom_tapping_term > 0) {
+        return action->custom_tapping_term;
+    }
+#ifdef TAPPING_TERM_PER_KEY
+    return get_tapping_term(action->state.keycode, NULL);
+#else
+    return TAPPING_TERM;
+#endif
+}
+
+/* Arms the deadline for the first tap dance to finish, once more than its
+ * term went by since its last tap. A finished dance still held is only
+ * reset by its release.
+ */
+static void tap_dance_set_deadline(void) {
+    uint16_t now     = timer_read();
+    bool     running = false;
+    uint16_t wait    = 0;
+    for (uint8_t i = 0; i <= highest_td; i++) {
+        qk_tap_dance_action_t *action = &tap_dance_actions[i];
+        if (!action->state.count || (action->state.finished && action->state.pressed)) continue;
+
+        uint16_t elapsed = TIMER_DIFF_16(now, action->state.timer);
+        uint16_t term    = tap_dance_term(action);
+        uint16_t left    = elapsed > term ? 0 : term + 1 - elapsed;
+        if (!running || left < wait) wait = left;
+        running = true;
+    }
+
+    if (running) {
+        deadline_set(DEADLINE_TAP_DANCE, now + wait);
+    } else {
+        deadline_clear(DEADLINE_TAP_DANCE);
+    }
+}
+
 void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
     qk_tap_dance_action_t *action;
 
@@ -115,7 +154,9 @@ void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
             if (keycode == action->state.keycode && keycode == last_td) continue;
             action->state.interrupted          = true;
             action->state.interrupting_keycode = keycode;
+            latency_trace_source_begin(last_td_key, true, LATENCY_TRACE_TAP_DANCE);
             process_tap_dance_action_on_dance_finished(action);
+            latency_trace_source_end();
             reset_tap_dance(&action->state);
 
             // Tap dance actions can leave some weak mods active (e.g., if the tap dance is mapped to a keycode with
@@ -148,7 +189,8 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
                 action->state.weak_mods |= get_weak_mods();
                 process_tap_dance_action_on_each_tap(action);
 
-                last_td = keycode;
+                last_td     = keycode;
+                last_td_key = record->event.key;
             } else {
                 if (action->state.count && action->state.finished) {
                     reset_tap_dance(&action->state);
@@ -158,29 +200,23 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
             break;
     }
 
+    if (highest_td != -1) tap_dance_set_deadline();
     return true;
 }
 
 void matrix_scan_tap_dance() {
-    if (highest_td == -1) return;
-    uint16_t tap_user_defined;
+    if (highest_td == -1 || !deadline_passed(DEADLINE_TAP_DANCE)) return;
 
     for (uint8_t i = 0; i <= highest_td; i++) {
         qk_tap_dance_action_t *action = &tap_dance_actions[i];
-        if (action->custom_tapping_term > 0) {
-            tap_user_defined = action->custom_tapping_term;
-        } else {
-#ifdef TAPPING_TERM_PER_KEY
-            tap_user_defined = get_tapping_term(action->state.keycode, NULL);
-#else
-            tap_user_defined = TAPPING_TERM;
-#endif
-        }
-        if (action->state.count && timer_elapsed(action->state.timer) > tap_user_defined) {
+        if (action->state.count && timer_elapsed(action->state.timer) > tap_dance_term(action)) {
+            latency_trace_source_begin(last_td_key, true, LATENCY_TRACE_TAP_DANCE);
             process_tap_dance_action_on_dance_finished(action);
+            latency_trace_source_end();
             reset_tap_dance(&action->state);
         }
     }
+    tap_dance_set_deadline();
 }
 
 void reset_tap_dance(qk_tap_dance_state_t *state) {
@@ -170,6 +170,16 @@ uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache) {
         return keymap_key_to_keycode(layer_switch_get_layer(event.key), event.key);
 }
 
+/* Sees the key events before tap-hold keys are resolved, may hold them back */
+bool pre_process_record_quantum(keyrecord_t *record) {
+#ifdef COMBO_ENABLE
+    if (!process_combo(get_record_keycode(record, true), record)) {
+        return false;
+    }
+#endif
+    return true;
+}
+
 /* Get keycode, and then call keyboard function */
 void post_process_record_quantum(keyrecord_t *record) {
     uint16_t keycode = get_record_keycode(record, false);
@@ -252,9 +262,6 @@ bool process_record_quantum(keyrecord_t *record) {
 #ifdef LEADER_ENABLE
             process_leader(keycode, record) &&
 #endif
-#ifdef COMBO_ENABLE
-            process_combo(keycode, record) &&
-#endif
 #ifdef PRINTING_ENABLE
             process_printer(keycode, record) &&
 #endif
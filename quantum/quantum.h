@@ -42,6 +42,7 @@
 #include "bootmagic.h"
 #include "timer.h"
 #include "sync_timer.h"
+#include "deadline.h"
 #include "config_common.h"
 #include "gpio.h"
 #include "atomic_util.h"
@@ -0,0 +1,191 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "scan_profile.h"
+#include "quantum.h"
+#include "debug.h"
+
+#if defined(PROTOCOL_CHIBIOS) && defined(__CORTEX_M) && (__CORTEX_M >= 3)
+#    define SCAN_PROFILE_USE_DWT
+#endif
+
+// Upper bound of the first histogram bucket is 2^this, each following bucket is 4 times wider
+#ifndef SCAN_PROFILE_HISTOGRAM_FIRST_BITS
+#    ifdef SCAN_PROFILE_USE_DWT
+#        define SCAN_PROFILE_HISTOGRAM_FIRST_BITS 8
+#    else
+#        define SCAN_PROFILE_HISTOGRAM_FIRST_BITS 0
+#    endif
+#endif
+
+static scan_profile_stats_t scan_profile_stats[SCAN_PROFILE_PHASE_COUNT];
+
+static const char *const scan_profile_phase_names[SCAN_PROFILE_PHASE_COUNT] = {
+    [SCAN_PROFILE_KEYBOARD_TASK]   = "keyboard_task",
+    [SCAN_PROFILE_MATRIX_SCAN]     = "matrix_scan",
+    [SCAN_PROFILE_DEBOUNCE]        = "debounce",
+    [SCAN_PROFILE_SPLIT_TRANSPORT] = "split_transport",
+    [SCAN_PROFILE_ACTION_EXEC]     = "action_exec",
+    [SCAN_PROFILE_LIGHTING]        = "lighting",
+    [SCAN_PROFILE_OLED]            = "oled",
+};
+
+void scan_profile_init(void) {
+#ifdef SCAN_PROFILE_USE_DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    scan_profile_reset();
+}
+
+/** \brief Current value of the profiling counter
+ *
+ * Only differences between two reads are meaningful, wrap-around included.
+ */
+__attribute__((weak)) uint32_t scan_profile_read(void) {
+#ifdef SCAN_PROFILE_USE_DWT
+    return DWT->CYCCNT;
+#else
+    return timer_read32();
+#endif
+}
+
+__attribute__((weak)) uint8_t scan_profile_unit(void) {
+#ifdef SCAN_PROFILE_USE_DWT
+    return SCAN_PROFILE_UNIT_CYCLES;
+#else
+    return SCAN_PROFILE_UNIT_MILLISECONDS;
+#endif
+}
+
+static uint8_t scan_profile_bucket(uint32_t ticks) {
+    uint8_t  bucket = 0;
+    uint32_t limit  = (uint32_t)1 << SCAN_PROFILE_HISTOGRAM_FIRST_BITS;
+    while (bucket < SCAN_PROFILE_HISTOGRAM_BUCKETS - 1 && ticks >= limit) {
+        bucket++;
+        limit <<= 2;
+    }
+    return bucket;
+}
+
+void scan_profile_record(scan_profile_phase_t phase, uint32_t ticks) {
+    scan_profile_stats_t *stats = &scan_profile_stats[phase];
+
+    if (ticks < stats->min) stats->min = ticks;
+    if (ticks > stats->max) stats->max = ticks;
+    // keep the average rather than overflow when nothing resets the numbers
+    if (stats->sum + ticks < stats->sum) {
+        stats->sum >>= 1;
+        stats->count >>= 1;
+    }
+    stats->sum += ticks;
+    stats->count++;
+
+    uint16_t *bucket = &stats->histogram[scan_profile_bucket(ticks)];
+    if (*bucket < UINT16_MAX) (*bucket)++;
+}
+
+void scan_profile_reset(void) {
+    memset(scan_profile_stats, 0, sizeof(scan_profile_stats));
+    for (uint8_t i = 0; i < SCAN_PROFILE_PHASE_COUNT; i++) {
+        scan_profile_stats[i].min = UINT32_MAX;
+    }
+}
+
+const scan_profile_stats_t *scan_profile_get_stats(scan_profile_phase_t phase) { return &scan_profile_stats[phase]; }
+
+uint32_t scan_profile_get_avg(scan_profile_phase_t phase) {
+    const scan_profile_stats_t *stats = &scan_profile_stats[phase];
+    return stats->count ? stats->sum / stats->count : 0;
+}
+
+const char *scan_profile_phase_name(scan_profile_phase_t phase) { return scan_profile_phase_names[phase]; }
+
+void scan_profile_print(void) {
+    uprintf("scan profile (%s):\n", scan_profile_unit() == SCAN_PROFILE_UNIT_CYCLES ? "cycles" : "ms");
+    for (uint8_t i = 0; i < SCAN_PROFILE_PHASE_COUNT; i++) {
+        const scan_profile_stats_t *stats = &scan_profile_stats[i];
+        if (!stats->count) continue;
+
+        uprintf("  %-15s min %lu avg %lu max %lu |", scan_profile_phase_names[i], stats->min, scan_profile_get_avg(i), stats->max);
+        for (uint8_t b = 0; b < SCAN_PROFILE_HISTOGRAM_BUCKETS; b++) {
+            uprintf(" %u", stats->histogram[b]);
+        }
+        uprintf("\n");
+    }
+}
+
+/** \brief Prints the numbers and starts over every SCAN_PROFILE_INTERVAL
+ *
+ * Without a console the numbers keep accumulating until queried or reset over raw HID.
+ */
+void scan_profile_task(void) {
+#ifdef CONSOLE_ENABLE
+    static uint32_t scan_profile_timer = 0;
+
+    uint32_t timer_now = timer_read32();
+    if (TIMER_DIFF_32(timer_now, scan_profile_timer) > SCAN_PROFILE_INTERVAL) {
+        scan_profile_print();
+        scan_profile_reset();
+        scan_profile_timer = timer_now;
+    }
+#endif
+}
+
+static void scan_profile_put_uint32(uint8_t *data, uint32_t value) {
+    data[0] = (value >> 24) & 0xFF;
+    data[1] = (value >> 16) & 0xFF;
+    data[2] = (value >> 8) & 0xFF;
+    data[3] = value & 0xFF;
+}
+
+bool scan_profile_raw_hid_query(uint8_t *data, uint8_t length) {
+    uint8_t phase    = data[0];
+    uint8_t selector = data[1];
+
+    if (phase >= SCAN_PROFILE_PHASE_COUNT || length < 4 + 2 * SCAN_PROFILE_HISTOGRAM_BUCKETS || length < 20) {
+        return false;
+    }
+
+    const scan_profile_stats_t *stats = &scan_profile_stats[phase];
+    switch (selector) {
+        case 0:
+            // unit, phase count, then min, avg, max and sample count
+            data[2] = scan_profile_unit();
+            data[3] = SCAN_PROFILE_PHASE_COUNT;
+            scan_profile_put_uint32(&data[4], stats->count ? stats->min : 0);
+            scan_profile_put_uint32(&data[8], scan_profile_get_avg(phase));
+            scan_profile_put_uint32(&data[12], stats->max);
+            scan_profile_put_uint32(&data[16], stats->count);
+            return true;
+        case 1:
+            // bucket count, first bucket bits, then the buckets
+            data[2] = SCAN_PROFILE_HISTOGRAM_BUCKETS;
+            data[3] = SCAN_PROFILE_HISTOGRAM_FIRST_BITS;
+            for (uint8_t b = 0; b < SCAN_PROFILE_HISTOGRAM_BUCKETS; b++) {
+                data[4 + 2 * b] = stats->histogram[b] >> 8;
+                data[5 + 2 * b] = stats->histogram[b] & 0xFF;
+            }
+            return true;
+        case 2:
+            scan_profile_reset();
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,89 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Scan-phase profiling.
+ *
+ * Each phase of keyboard_task() is timed with the fastest counter available
+ * (the DWT cycle counter on Cortex-M3 and up, milliseconds elsewhere), and
+ * min/avg/max plus a coarse histogram are kept per phase. Phases can nest:
+ * debounce and split transport are also counted in matrix scan.
+ */
+
+typedef enum {
+    SCAN_PROFILE_KEYBOARD_TASK,
+    SCAN_PROFILE_MATRIX_SCAN,
+    SCAN_PROFILE_DEBOUNCE,
+    SCAN_PROFILE_SPLIT_TRANSPORT,
+    SCAN_PROFILE_ACTION_EXEC,
+    SCAN_PROFILE_LIGHTING,
+    SCAN_PROFILE_OLED,
+    SCAN_PROFILE_PHASE_COUNT,
+} scan_profile_phase_t;
+
+#ifndef SCAN_PROFILE_HISTOGRAM_BUCKETS
+#    define SCAN_PROFILE_HISTOGRAM_BUCKETS 8
+#endif
+
+// Console report and reset interval, in milliseconds
+#ifndef SCAN_PROFILE_INTERVAL
+#    define SCAN_PROFILE_INTERVAL 1000
+#endif
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint32_t count;
+    uint16_t histogram[SCAN_PROFILE_HISTOGRAM_BUCKETS];
+} scan_profile_stats_t;
+
+#ifdef SCAN_PROFILE_ENABLE
+
+// Reported with every set of numbers, so they can be read without knowing the build
+#    define SCAN_PROFILE_UNIT_CYCLES 0
+#    define SCAN_PROFILE_UNIT_MILLISECONDS 1
+
+void     scan_profile_init(void);
+uint32_t scan_profile_read(void);
+uint8_t  scan_profile_unit(void);
+void     scan_profile_record(scan_profile_phase_t phase, uint32_t ticks);
+void     scan_profile_reset(void);
+void     scan_profile_task(void);
+void     scan_profile_print(void);
+
+const scan_profile_stats_t *scan_profile_get_stats(scan_profile_phase_t phase);
+uint32_t                    scan_profile_get_avg(scan_profile_phase_t phase);
+const char *                scan_profile_phase_name(scan_profile_phase_t phase);
+
+/* Fills a raw HID response: data[0] is the phase, data[1] selects the
+ * summary (0), the histogram (1) or a reset (2). Returns false for an unknown
+ * phase or selector.
+ */
+bool scan_profile_raw_hid_query(uint8_t *data, uint8_t length);
+
+#    define SCAN_PROFILE_START(name) uint32_t name = scan_profile_read()
+#    define SCAN_PROFILE_END(phase, name) scan_profile_record(phase, scan_profile_read() - (name))
+#else
+#    define scan_profile_init()
+#    define scan_profile_task()
+#    define SCAN_PROFILE_START(name)
+#    define SCAN_PROFILE_END(phase, name)
+#endif
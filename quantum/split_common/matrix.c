@@ -23,6 +23,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "split_util.h"
 #include "config.h"
 #include "transport.h"
+#include "scan_profile.h"
+#ifdef MATRIX_WAKE_ENABLE
+#    include "matrix_wake.h"
+#endif
+#ifdef SPLIT_KEY_EVENTS
+#    include "split_key_events.h"
+#endif
 
 #define ERROR_DISCONNECT_COUNT 5
 
@@ -93,6 +100,9 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
 
 #elif defined(DIODE_DIRECTION)
 #    if (DIODE_DIRECTION == COL2ROW)
+#        ifdef MATRIX_PORT_GROUPED_READ
+#            include "matrix_ports.h"
+#        endif
 
 static void select_row(uint8_t row) { setPinOutput_writeLow(row_pins[row]); }
 
@@ -109,6 +119,9 @@ static void init_pins(void) {
     for (uint8_t x = 0; x < MATRIX_COLS; x++) {
         setPinInputHigh_atomic(col_pins[x]);
     }
+#        ifdef MATRIX_PORT_GROUPED_READ
+    matrix_ports_init(col_pins);
+#        endif
 }
 
 static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row) {
@@ -119,6 +132,10 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
     select_row(current_row);
     matrix_output_select_delay();
 
+#        ifdef MATRIX_PORT_GROUPED_READ
+    // Read each port once, active low
+    current_row_value = matrix_ports_read_low(col_pins);
+#        else
     // For each col...
     for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++) {
         // Select the col pin to read (active low)
@@ -127,6 +144,7 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
         // Populate the matrix row with the state of the col pin
         current_row_value |= pin_state ? 0 : (MATRIX_ROW_SHIFTER << col_index);
     }
+#        endif
 
     // Unselect row
     unselect_row(current_row);
@@ -202,6 +220,58 @@ static bool read_rows_on_col(matrix_row_t current_matrix[], uint8_t current_col)
 #    error DIODE_DIRECTION is not defined!
 #endif
 
+#ifdef MATRIX_WAKE_ENABLE
+#    ifdef DIRECT_PINS
+#        define WAKE_INPUT_PINS ((const pin_t *)direct_pins)
+#        define WAKE_INPUT_COUNT (ROWS_PER_HAND * MATRIX_COLS)
+#    elif (DIODE_DIRECTION == COL2ROW)
+#        define WAKE_INPUT_PINS col_pins
+#        define WAKE_INPUT_COUNT MATRIX_COLS
+#    else
+#        define WAKE_INPUT_PINS row_pins
+#        define WAKE_INPUT_COUNT ROWS_PER_HAND
+#    endif
+
+void matrix_wake_arm_pins(void) {
+#    if !defined(DIRECT_PINS)
+    // Drive every output, so that any key pulls its input low
+#        if (DIODE_DIRECTION == COL2ROW)
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        select_row(row);
+    }
+#        else
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        select_col(col);
+    }
+#        endif
+    matrix_output_select_delay();
+#    endif
+    matrix_wake_enable_interrupts(WAKE_INPUT_PINS, WAKE_INPUT_COUNT);
+}
+
+void matrix_wake_disarm_pins(void) {
+    matrix_wake_disable_interrupts(WAKE_INPUT_PINS, WAKE_INPUT_COUNT);
+#    if !defined(DIRECT_PINS)
+#        if (DIODE_DIRECTION == COL2ROW)
+    unselect_rows();
+#        else
+    unselect_cols();
+#        endif
+    matrix_output_unselect_delay();
+#    endif
+}
+
+bool matrix_wake_inputs_idle(void) {
+    const pin_t *pins = WAKE_INPUT_PINS;
+    for (uint16_t i = 0; i < WAKE_INPUT_COUNT; i++) {
+        if (pins[i] != NO_PIN && !readPin(pins[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 void matrix_init(void) {
     split_pre_init();
 
@@ -234,6 +304,16 @@ void matrix_init(void) {
 
     // initialize key pins
     init_pins();
+#if defined(MATRIX_IO_DELAY_CALIBRATE) && !defined(DIRECT_PINS)
+#    if (DIODE_DIRECTION == COL2ROW)
+    matrix_io_delay_calibrate(col_pins, MATRIX_COLS);
+#    else
+    matrix_io_delay_calibrate(row_pins, ROWS_PER_HAND);
+#    endif
+#endif
+#ifdef MATRIX_WAKE_ENABLE
+    matrix_wake_init();
+#endif
 
     // initialize matrix state: all keys off
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
@@ -254,7 +334,10 @@ bool matrix_post_scan(void) {
         static uint8_t error_count;
 
         matrix_row_t slave_matrix[ROWS_PER_HAND] = {0};
-        if (!transport_master(matrix + thisHand, slave_matrix)) {
+        SCAN_PROFILE_START(transport_start);
+        bool transport_ok = transport_master(matrix + thisHand, slave_matrix);
+        SCAN_PROFILE_END(SCAN_PROFILE_SPLIT_TRANSPORT, transport_start);
+        if (!transport_ok) {
             error_count++;
 
             if (error_count > ERROR_DISCONNECT_COUNT) {
@@ -279,7 +362,9 @@ bool matrix_post_scan(void) {
 
         matrix_scan_quantum();
     } else {
+        SCAN_PROFILE_START(transport_start);
         transport_slave(matrix + thatHand, matrix + thisHand);
+        SCAN_PROFILE_END(SCAN_PROFILE_SPLIT_TRANSPORT, transport_start);
 
         matrix_slave_scan_kb();
     }
@@ -290,6 +375,15 @@ bool matrix_post_scan(void) {
 uint8_t matrix_scan(void) {
     bool local_changed = false;
 
+#ifdef MATRIX_WAKE_ENABLE
+    if (matrix_wake_idle()) {
+        bool remote_changed = matrix_post_scan();
+        // Activity on the other half resumes scanning here too
+        if (remote_changed) matrix_wake_edge();
+        return (uint8_t)remote_changed;
+    }
+#endif
+
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
@@ -302,8 +396,25 @@ uint8_t matrix_scan(void) {
     }
 #endif
 
+    SCAN_PROFILE_START(debounce_start);
     debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, local_changed);
+    SCAN_PROFILE_END(SCAN_PROFILE_DEBOUNCE, debounce_start);
+
+#ifdef SPLIT_KEY_EVENTS
+    // Stamp the debounced edges here, before they wait for the master
+    if (!is_keyboard_master()) split_key_events_record(matrix + thisHand);
+#endif
 
     bool remote_changed = matrix_post_scan();
+
+#ifdef MATRIX_WAKE_ENABLE
+    // The master keeps scanning while the other half has keys down
+    bool keys_down = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        keys_down |= (row < ROWS_PER_HAND && raw_matrix[row]) || matrix[row];
+    }
+    matrix_wake_update(keys_down);
+#endif
+
     return (uint8_t)(local_changed || remote_changed);
 }
@@ -16,4 +16,12 @@
 // When using serial and RGBLIGHT_SPLIT need separate transaction
 #        define SERIAL_USE_MULTI_TRANSACTION
 #    endif
+// Delta transport sends each field in its own transaction
+#    if defined(SPLIT_TRANSPORT_DELTA) && !defined(SERIAL_USE_MULTI_TRANSACTION)
+#        define SERIAL_USE_MULTI_TRANSACTION
+#    endif
+// Adaptive speed works off the link statistics
+#    if defined(SOFT_SERIAL_ADAPTIVE_SPEED) && !defined(SPLIT_LINK_STATS)
+#        define SPLIT_LINK_STATS
+#    endif
 #endif
@@ -0,0 +1,184 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "split_key_events.h"
+#include "split_util.h"
+#include "sync_timer.h"
+#include "timer.h"
+
+#ifdef SPLIT_KEY_EVENTS
+
+#    ifdef USE_I2C
+#        error "SPLIT_KEY_EVENTS needs the serial transport"
+#    endif
+#    if defined(SPLIT_KEYBOARD) && defined(DISABLE_SYNC_TIMER)
+#        error "SPLIT_KEY_EVENTS needs the sync timer"
+#    endif
+
+#    define SEQ_DIFF(a, b) ((uint8_t)((a) - (b)))
+
+// Slave: the queue, oldest first, and the rows it accounts for
+static split_key_event_t queue[SPLIT_KEY_EVENTS_QUEUE_SIZE];
+static uint8_t           queue_head  = 0;
+static uint8_t           queue_count = 0;
+static uint8_t           queue_seq   = 0;  // sequence number of the oldest event
+static matrix_row_t      recorded[ROWS_PER_HAND];
+
+// Master: the rows as the applied events left them, and when those events happened
+static matrix_row_t      applied_rows[ROWS_PER_HAND];
+static split_key_event_t applied[SPLIT_KEY_EVENTS_PER_PACKET];
+static uint8_t           applied_count = 0;
+static uint8_t           next_seq      = 0;
+static uint16_t          last_time     = 0;  // latest time handed to action_exec()
+
+static void queue_push(uint8_t row, uint8_t col, bool pressed) {
+    if (queue_count == SPLIT_KEY_EVENTS_QUEUE_SIZE) {
+        // The master will see the gap and fall back to the rows
+        queue_head = (queue_head + 1) % SPLIT_KEY_EVENTS_QUEUE_SIZE;
+        queue_count--;
+        queue_seq++;
+    }
+    queue[(queue_head + queue_count) % SPLIT_KEY_EVENTS_QUEUE_SIZE] = (split_key_event_t){
+        .row  = row | (pressed ? SPLIT_KEY_EVENT_PRESSED : 0),
+        .col  = col,
+        .time = sync_timer_read() | 1,
+    };
+    queue_count++;
+}
+
+/** \brief On the slave, queues an event for every key that changed since the last call
+ */
+void split_key_events_record(const matrix_row_t rows[]) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        matrix_row_t changes = rows[row] ^ recorded[row];
+        for (uint8_t col = 0; changes; col++, changes >>= 1) {
+            if (changes & 1) queue_push(row, col, rows[row] & (MATRIX_ROW_SHIFTER << col));
+        }
+        recorded[row] = rows[row];
+    }
+}
+
+/** \brief On the slave, fills the packet with the oldest events
+ *
+ * The packet can be read by the transport interrupt at any time: the count
+ * is cleared first and written last, so a torn read carries no events.
+ * Returns true if the packet changed.
+ */
+bool split_key_events_fill(split_key_events_packet_t *packet) {
+    uint8_t count = queue_count < SPLIT_KEY_EVENTS_PER_PACKET ? queue_count : SPLIT_KEY_EVENTS_PER_PACKET;
+    if (packet->seq == queue_seq && packet->total == queue_count && packet->count == count) return false;
+
+    packet->count = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        packet->events[i] = queue[(queue_head + i) % SPLIT_KEY_EVENTS_QUEUE_SIZE];
+    }
+    packet->seq   = queue_seq;
+    packet->total = queue_count;
+    packet->count = count;
+    return true;
+}
+
+/** \brief On the slave, drops the events the master has applied
+ */
+void split_key_events_ack(uint8_t seq) {
+    uint8_t done = SEQ_DIFF(seq, queue_seq);
+    if (done == 0 || done > queue_count) return;
+
+    queue_head = (queue_head + done) % SPLIT_KEY_EVENTS_QUEUE_SIZE;
+    queue_count -= done;
+    queue_seq = seq;
+}
+
+/** \brief On the master, applies the events of the packet it has not applied yet
+ *
+ * Stops at the first event for a key that already changed in this call,
+ * so that both edges of a short tap reach action_exec() in order. rows[]
+ * gets the slave rows as the applied events left them.
+ */
+void split_key_events_apply(const split_key_events_packet_t *packet, const matrix_row_t slave_rows[], matrix_row_t rows[]) {
+    applied_count  = 0;
+    uint8_t offset = SEQ_DIFF(next_seq, packet->seq);
+
+    if (offset > packet->total) {
+        // Events were lost, start over from the slave rows
+        memcpy(applied_rows, slave_rows, sizeof(applied_rows));
+        next_seq = packet->seq + packet->total;
+    } else {
+        for (uint8_t i = offset; i < packet->count; i++) {
+            const split_key_event_t *event = &packet->events[i];
+            uint8_t                  row   = event->row & ~SPLIT_KEY_EVENT_PRESSED;
+            if (row >= ROWS_PER_HAND || event->col >= MATRIX_COLS) break;
+
+            bool seen = false;
+            for (uint8_t j = 0; j < applied_count; j++) {
+                seen |= applied[j].col == event->col && (applied[j].row & ~SPLIT_KEY_EVENT_PRESSED) == row;
+            }
+            if (seen) break;
+
+            if (event->row & SPLIT_KEY_EVENT_PRESSED) {
+                applied_rows[row] |= MATRIX_ROW_SHIFTER << event->col;
+            } else {
+                applied_rows[row] &= ~(MATRIX_ROW_SHIFTER << event->col);
+            }
+            applied[applied_count++] = *event;
+            next_seq++;
+        }
+
+        // Every queued event is in, the rows must agree
+        if (next_seq == (uint8_t)(packet->seq + packet->total) && memcmp(applied_rows, slave_rows, sizeof(applied_rows)) != 0) {
+            memcpy(applied_rows, slave_rows, sizeof(applied_rows));
+        }
+    }
+
+    memcpy(rows, applied_rows, sizeof(applied_rows));
+}
+
+/** \brief On the master, the acknowledgement for the slave: the next event it wants
+ */
+uint8_t split_key_events_next_seq(void) { return next_seq; }
+
+/** \brief The time of the change of the key, for action_exec()
+ *
+ * Keys of the slave half that changed through an event get the time of
+ * the event, everything else the time of the scan. Called once for every
+ * key event, master or slave, in the order they go to action_exec(), so no
+ * time comes out earlier than the one before: a slave edge that arrives
+ * after a later master edge gets that master edge's time. Otherwise the
+ * tapping engine would see a negative difference, which wraps around and
+ * turns a mod-tap into a hold at once. The edges are not reordered: that
+ * slave edge still comes after the master one, though it happened first.
+ */
+uint16_t split_key_events_time(uint8_t row, uint8_t col, uint16_t scan_time) {
+    uint8_t  slave_row = row - (isLeftHand ? ROWS_PER_HAND : 0);
+    uint16_t time      = scan_time;
+
+    for (uint8_t i = 0; i < applied_count; i++) {
+        if (applied[i].col != col || (applied[i].row & ~SPLIT_KEY_EVENT_PRESSED) != slave_row) continue;
+        uint16_t age = scan_time - applied[i].time;
+        if (age <= SPLIT_KEY_EVENTS_MAX_AGE) time = applied[i].time;
+        break;
+    }
+
+    if ((uint16_t)(scan_time - time) > (uint16_t)(scan_time - last_time)) {
+        time = last_time;
+    }
+    last_time = time;
+    return time;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "matrix.h"
+
+/* Timestamped key events from the slave half, enabled with SPLIT_KEY_EVENTS.
+ *
+ * The slave already debounces its own rows. With this, it also turns every
+ * debounced edge into an event stamped with the synchronized clock, and
+ * queues it until the master acknowledges it. The master applies the
+ * events in order, at most one per key and scan, and hands their slave
+ * side time to action_exec() instead of the time of its own scan.
+ *
+ * The slave rows still travel along: if events were lost, because the
+ * queue overflowed or a half restarted, the master takes the rows as they
+ * are and carries on with the events that follow.
+ */
+
+#ifndef ROWS_PER_HAND
+#    define ROWS_PER_HAND (MATRIX_ROWS / 2)
+#endif
+
+// Events the slave keeps until they are acknowledged, the oldest is dropped beyond
+#ifndef SPLIT_KEY_EVENTS_QUEUE_SIZE
+#    define SPLIT_KEY_EVENTS_QUEUE_SIZE 16
+#endif
+
+// Events sent per exchange
+#ifndef SPLIT_KEY_EVENTS_PER_PACKET
+#    define SPLIT_KEY_EVENTS_PER_PACKET 4
+#endif
+
+// An event older than this, or from the future, gets the master's time instead
+#ifndef SPLIT_KEY_EVENTS_MAX_AGE
+#    define SPLIT_KEY_EVENTS_MAX_AGE 500
+#endif
+
+#define SPLIT_KEY_EVENT_PRESSED 0x80
+
+typedef struct {
+    uint8_t  row;  // row in the slave half, SPLIT_KEY_EVENT_PRESSED for a press
+    uint8_t  col;
+    uint16_t time;  // sync_timer_read() on the slave
+} split_key_event_t;
+
+typedef struct {
+    uint8_t           seq;    // sequence number of events[0]
+    uint8_t           total;  // events queued on the slave, events[] holds the first ones
+    uint8_t           count;
+    split_key_event_t events[SPLIT_KEY_EVENTS_PER_PACKET];
+} split_key_events_packet_t;
+
+// slave
+void split_key_events_record(const matrix_row_t rows[]);
+bool split_key_events_fill(split_key_events_packet_t *packet);
+void split_key_events_ack(uint8_t next_seq);
+
+// master
+void     split_key_events_apply(const split_key_events_packet_t *packet, const matrix_row_t slave_rows[], matrix_row_t rows[]);
+uint8_t  split_key_events_next_seq(void);
+uint16_t split_key_events_time(uint8_t row, uint8_t col, uint16_t scan_time);
@@ -0,0 +1,198 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "split_link.h"
+#include "serial.h"
+#include "timer.h"
+#include "print.h"
+#include "debug.h"
+
+#ifdef SPLIT_LINK_STATS
+
+#    if defined(SOFT_SERIAL_ADAPTIVE_SPEED) && !defined(SERIAL_DRIVER_BITBANG)
+#        error "SOFT_SERIAL_ADAPTIVE_SPEED needs SERIAL_DRIVER = bitbang"
+#    endif
+
+static split_link_stats_t stats[SPLIT_LINK_STATS_COUNT];
+
+static inline void count(uint16_t *counter) {
+    if (*counter < UINT16_MAX) (*counter)++;
+}
+
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+#        define SLOWEST_SPEED (SOFT_SERIAL_SPEED_COUNT - 1)
+
+static uint8_t  requested_speed = SELECT_SOFT_SERIAL_SPEED;
+static uint8_t  fastest_speed   = SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST;  // lowered each time a speed fails
+static uint16_t window_count    = 0;
+static uint16_t window_errors   = 0;
+static uint16_t last_success    = 0;
+static uint32_t last_slowdown   = 0;  // when fastest_speed was last lowered
+
+static void restart_window(void) {
+    window_count  = 0;
+    window_errors = 0;
+}
+
+static void adapt_speed(bool success) {
+    if (success) {
+        last_success = timer_read();
+    } else {
+        window_errors++;
+    }
+    // A speed change is in flight, let it land first
+    if (requested_speed != soft_serial_get_speed()) return;
+    if (++window_count < SOFT_SERIAL_ADAPTIVE_SPEED_WINDOW) return;
+
+    uint8_t speed = soft_serial_get_speed();
+    if (window_errors > SOFT_SERIAL_ADAPTIVE_SPEED_MAX_ERRORS && speed < SLOWEST_SPEED) {
+        fastest_speed   = speed + 1;
+        requested_speed = speed + 1;
+        last_slowdown   = timer_read32();
+        dprintf("split_link: slowing down to speed %u\n", requested_speed);
+    } else if (window_errors == 0 && speed == fastest_speed && speed > SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST && timer_elapsed32(last_slowdown) >= SOFT_SERIAL_ADAPTIVE_SPEED_RECOVERY) {
+        // Whatever made the faster speed fail may be gone, give it another try
+        fastest_speed   = speed - 1;
+        requested_speed = speed - 1;
+        last_slowdown   = timer_read32();
+        dprintf("split_link: trying speed %u again\n", requested_speed);
+    } else if (window_errors == 0 && speed > fastest_speed) {
+        requested_speed = speed - 1;
+        dprintf("split_link: speeding up to speed %u\n", requested_speed);
+    }
+    restart_window();
+}
+
+/** \brief The speed the master wants the slave to use, sent along the next transactions
+ */
+uint8_t split_link_requested_speed(void) { return requested_speed; }
+
+/** \brief Falls back to the slowest speed once the link has been down for a while
+ *
+ * Called by the master before its transactions, the slave does the same on its side.
+ */
+void split_link_master_task(void) {
+    if (soft_serial_get_speed() != SLOWEST_SPEED && timer_elapsed(last_success) > SOFT_SERIAL_ADAPTIVE_SPEED_TIMEOUT) {
+        dprintf("split_link: link lost, falling back to speed %u\n", SLOWEST_SPEED);
+        requested_speed = SLOWEST_SPEED;
+        soft_serial_set_speed(SLOWEST_SPEED);
+        restart_window();
+    }
+}
+
+/** \brief The slave received the speed, so the master switches to it too
+ */
+void split_link_speed_sent(uint8_t speed) {
+    if (speed != soft_serial_get_speed()) {
+        soft_serial_set_speed(speed);
+        restart_window();
+    }
+}
+
+/** \brief On the slave, applies the speed the master sent
+ */
+void split_link_slave_received(uint8_t speed) {
+    if (speed < SOFT_SERIAL_SPEED_COUNT && speed != soft_serial_get_speed()) {
+        soft_serial_set_speed(speed);
+    }
+}
+
+/** \brief On the slave, falls back to the slowest speed once nothing arrived for a while
+ */
+void split_link_slave_task(bool accepted) {
+    if (accepted) {
+        last_success = timer_read();
+    } else if (soft_serial_get_speed() != SLOWEST_SPEED && timer_elapsed(last_success) > SOFT_SERIAL_ADAPTIVE_SPEED_TIMEOUT) {
+        soft_serial_set_speed(SLOWEST_SPEED);
+    }
+}
+#    endif
+
+/** \brief Counts the outcome of a transaction started by the master
+ */
+void split_link_record(uint8_t transaction_id, int result) {
+    split_link_stats_t *entry = &stats[transaction_id < SPLIT_LINK_STATS_COUNT ? transaction_id : SPLIT_LINK_STATS_COUNT - 1];
+
+    switch (result) {
+        case TRANSACTION_END:
+            count(&entry->success);
+            break;
+        case TRANSACTION_NO_RESPONSE:
+            count(&entry->timeout);
+            break;
+        case TRANSACTION_DATA_ERROR:
+            count(&entry->checksum);
+            break;
+        default:
+            count(&entry->failure);
+            break;
+    }
+
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    adapt_speed(result == TRANSACTION_END);
+#    endif
+}
+
+const split_link_stats_t *split_link_stats(uint8_t transaction_id) { return transaction_id < SPLIT_LINK_STATS_COUNT ? &stats[transaction_id] : NULL; }
+
+void split_link_stats_reset(void) { memset(stats, 0, sizeof(stats)); }
+
+/** \brief Prints one line per transaction id that was used
+ */
+void split_link_stats_print(void) {
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    uprintf("split_link: speed %u, fastest %u\n", soft_serial_get_speed(), fastest_speed);
+#    endif
+    for (uint8_t id = 0; id < SPLIT_LINK_STATS_COUNT; id++) {
+        const split_link_stats_t *entry = &stats[id];
+        if (!(entry->success || entry->timeout || entry->checksum || entry->failure)) continue;
+        uprintf("split_link: %u ok %u timeout %u checksum %u failure %u\n", id, entry->success, entry->timeout, entry->checksum, entry->failure);
+    }
+}
+
+/** \brief Answers a raw HID report asking for the counters of one transaction
+ *
+ * data[1] holds the transaction id. The answer puts the current speed in
+ * data[2] (0xFF without SOFT_SERIAL_ADAPTIVE_SPEED), followed by the
+ * success, timeout, checksum and failure counters, big-endian. data[0] is
+ * left to the caller's command id.
+ */
+void split_link_stats_raw_hid(uint8_t *data, uint8_t length) {
+    if (length < 11) return;
+
+    const split_link_stats_t *entry = split_link_stats(data[1]);
+    uint16_t                  counters[4] = {0};
+    if (entry) {
+        counters[0] = entry->success;
+        counters[1] = entry->timeout;
+        counters[2] = entry->checksum;
+        counters[3] = entry->failure;
+    }
+
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    data[2] = soft_serial_get_speed();
+#    else
+    data[2] = 0xFF;
+#    endif
+    for (uint8_t i = 0; i < 4; i++) {
+        data[3 + i * 2] = counters[i] >> 8;
+        data[4 + i * 2] = counters[i] & 0xFF;
+    }
+}
+
+#endif
@@ -0,0 +1,84 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Split link statistics, enabled with SPLIT_LINK_STATS.
+ *
+ * The master counts the outcome of every serial transaction, per
+ * transaction id. The counters saturate instead of wrapping.
+ *
+ * With SOFT_SERIAL_ADAPTIVE_SPEED the same outcomes drive the bitbang
+ * serial speed: after SOFT_SERIAL_ADAPTIVE_SPEED_WINDOW transactions without
+ * an error the master asks the slave to go one step faster, and after a
+ * window with more than SOFT_SERIAL_ADAPTIVE_SPEED_MAX_ERRORS errors one
+ * step slower. The speed that failed is not tried again until the link
+ * ran SOFT_SERIAL_ADAPTIVE_SPEED_RECOVERY milliseconds without slowing
+ * down, then the master steps up one speed at a time. When no
+ * transaction went through for SOFT_SERIAL_ADAPTIVE_SPEED_TIMEOUT
+ * milliseconds, both halves fall back to the slowest speed on their own.
+ */
+
+typedef struct {
+    uint16_t success;
+    uint16_t timeout;   // the slave did not answer
+    uint16_t checksum;  // the data arrived corrupted
+    uint16_t failure;   // anything else, like an unknown transaction
+} split_link_stats_t;
+
+// Transaction ids above this are counted in the last slot
+#ifndef SPLIT_LINK_STATS_COUNT
+#    define SPLIT_LINK_STATS_COUNT 8
+#endif
+
+#ifndef SOFT_SERIAL_ADAPTIVE_SPEED_WINDOW
+#    define SOFT_SERIAL_ADAPTIVE_SPEED_WINDOW 500
+#endif
+
+#ifndef SOFT_SERIAL_ADAPTIVE_SPEED_MAX_ERRORS
+#    define SOFT_SERIAL_ADAPTIVE_SPEED_MAX_ERRORS 5
+#endif
+
+#ifndef SOFT_SERIAL_ADAPTIVE_SPEED_TIMEOUT
+#    define SOFT_SERIAL_ADAPTIVE_SPEED_TIMEOUT 100
+#endif
+
+// Milliseconds without a slow down before a failed speed is tried again
+#ifndef SOFT_SERIAL_ADAPTIVE_SPEED_RECOVERY
+#    define SOFT_SERIAL_ADAPTIVE_SPEED_RECOVERY 60000
+#endif
+
+// Fastest speed ever tried, same scale as SELECT_SOFT_SERIAL_SPEED
+#ifndef SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST
+#    define SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST 0
+#endif
+
+void                      split_link_record(uint8_t transaction_id, int result);
+const split_link_stats_t *split_link_stats(uint8_t transaction_id);
+void                      split_link_stats_reset(void);
+void                      split_link_stats_print(void);
+void                      split_link_stats_raw_hid(uint8_t *data, uint8_t length);
+
+#ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+uint8_t split_link_requested_speed(void);
+void    split_link_master_task(void);
+void    split_link_speed_sent(uint8_t speed);
+void    split_link_slave_received(uint8_t speed);
+void    split_link_slave_task(bool accepted);
+#endif
@@ -0,0 +1,30 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// What transport.c needs from quantum.h, the simulator provides it per half
+#include <stdint.h>
+#include <stdbool.h>
+#include "timer.h"
+
+uint8_t get_mods(void);
+void    set_mods(uint8_t mods);
+uint8_t get_weak_mods(void);
+void    set_weak_mods(uint8_t mods);
+uint8_t get_oneshot_mods(void);
+void    set_oneshot_mods(uint8_t mods);
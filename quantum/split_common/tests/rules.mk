@@ -0,0 +1,74 @@
+# Copyright 2021 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Both halves of a split keyboard, looped back in memory, see split_sim.h.
+# Each transport is built once per half, with the same features.
+SPLIT_SIM_PATH := $(QUANTUM_PATH)/split_common
+
+SPLIT_SIM_DEFS := -DNO_DEBUG -DDISABLE_SYNC_TIMER -DSPLIT_TRANSPORT_MIRROR -DSPLIT_MODS_ENABLE
+
+SPLIT_SIM_INC := $(SPLIT_SIM_PATH)/tests $(SPLIT_SIM_PATH) $(DRIVER_PATH)/chibios
+
+SPLIT_SIM_SRC := \
+	$(SPLIT_SIM_PATH)/tests/split_transport_tests.cpp \
+	$(SPLIT_SIM_PATH)/tests/split_sim.c \
+	$(SPLIT_SIM_PATH)/tests/split_sim_master.c \
+	$(SPLIT_SIM_PATH)/tests/split_sim_slave.c \
+	$(TMK_PATH)/common/test/timer.c
+
+split_transport_serial_DEFS := $(SPLIT_SIM_DEFS)
+split_transport_serial_INC := $(SPLIT_SIM_INC)
+split_transport_serial_SRC := $(SPLIT_SIM_SRC)
+
+split_transport_delta_DEFS := $(SPLIT_SIM_DEFS) -DSPLIT_TRANSPORT_DELTA -DSERIAL_USE_MULTI_TRANSACTION
+split_transport_delta_INC := $(SPLIT_SIM_INC)
+split_transport_delta_SRC := $(SPLIT_SIM_SRC)
+
+split_transport_i2c_DEFS := $(SPLIT_SIM_DEFS) -DUSE_I2C
+split_transport_i2c_INC := $(SPLIT_SIM_INC)
+split_transport_i2c_SRC := $(SPLIT_SIM_SRC)
+
+SPLIT_KEY_EVENTS_SRC := $(filter-out %/split_transport_tests.cpp,$(SPLIT_SIM_SRC)) \
+	$(SPLIT_SIM_PATH)/tests/split_key_events_tests.cpp
+
+split_key_events_serial_DEFS := $(SPLIT_SIM_DEFS) -DSPLIT_KEY_EVENTS
+split_key_events_serial_INC := $(SPLIT_SIM_INC)
+split_key_events_serial_SRC := $(SPLIT_KEY_EVENTS_SRC)
+
+split_key_events_delta_DEFS := $(SPLIT_SIM_DEFS) -DSPLIT_KEY_EVENTS -DSPLIT_TRANSPORT_DELTA -DSERIAL_USE_MULTI_TRANSACTION
+split_key_events_delta_INC := $(SPLIT_SIM_INC)
+split_key_events_delta_SRC := $(SPLIT_KEY_EVENTS_SRC)
+
+SPLIT_LINK_SRC := $(filter-out %/split_transport_tests.cpp,$(SPLIT_SIM_SRC)) \
+	$(SPLIT_SIM_PATH)/tests/split_link_tests.cpp
+
+# Faster recovery than the default, so the tests do not scan for a minute
+SPLIT_LINK_SPEED_DEFS := -DSPLIT_LINK_STATS -DSOFT_SERIAL_ADAPTIVE_SPEED -DSERIAL_DRIVER_BITBANG -DSOFT_SERIAL_ADAPTIVE_SPEED_RECOVERY=10000
+
+split_link_stats_serial_DEFS := $(SPLIT_SIM_DEFS) -DSPLIT_LINK_STATS
+split_link_stats_serial_INC := $(SPLIT_SIM_INC)
+split_link_stats_serial_SRC := $(SPLIT_LINK_SRC)
+
+split_link_stats_delta_DEFS := $(SPLIT_SIM_DEFS) -DSPLIT_LINK_STATS -DSPLIT_TRANSPORT_DELTA -DSERIAL_USE_MULTI_TRANSACTION
+split_link_stats_delta_INC := $(SPLIT_SIM_INC)
+split_link_stats_delta_SRC := $(SPLIT_LINK_SRC)
+
+split_link_speed_serial_DEFS := $(SPLIT_SIM_DEFS) $(SPLIT_LINK_SPEED_DEFS)
+split_link_speed_serial_INC := $(SPLIT_SIM_INC)
+split_link_speed_serial_SRC := $(SPLIT_LINK_SRC)
+
+split_link_speed_delta_DEFS := $(SPLIT_SIM_DEFS) $(SPLIT_LINK_SPEED_DEFS) -DSPLIT_TRANSPORT_DELTA -DSERIAL_USE_MULTI_TRANSACTION
+split_link_speed_delta_INC := $(SPLIT_SIM_INC)
+split_link_speed_delta_SRC := $(SPLIT_LINK_SRC)
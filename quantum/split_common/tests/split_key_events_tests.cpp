@@ -0,0 +1,167 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+extern "C" {
+#include "split_sim.h"
+#include "split_key_events.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// The slave half's rows come after the master's
+#define SLAVE_ROW(row) (SPLIT_SIM_ROWS + (row))
+
+class SplitKeyEvents : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+        split_sim_init();
+        for (int i = 0; i < 600; i++) {
+            split_sim_scan();
+            advance_time(1);
+        }
+    }
+
+    // The slave scans every millisecond, the master only every `master_every`
+    void run(uint32_t ms, uint32_t master_every) {
+        for (uint32_t i = 1; i <= ms; i++) {
+            advance_time(1);
+            split_sim_slave_scan();
+            if (timer_read() % master_every == 0) master_scan();
+        }
+    }
+
+    // A master scan, counting the slave key changes it sees
+    void master_scan(void) {
+        matrix_row_t previous[SPLIT_SIM_ROWS];
+        memcpy(previous, split_sim_master.remote, sizeof(previous));
+        if (!split_sim_master_scan()) return;
+        for (int row = 0; row < SPLIT_SIM_ROWS; row++) {
+            edges += __builtin_popcount(previous[row] ^ split_sim_master.remote[row]);
+        }
+    }
+
+    uint16_t key_time(uint8_t row, uint8_t col) { return master_split_key_events_time(row, col, timer_read()); }
+
+    int edges = 0;
+};
+
+TEST_F(SplitKeyEvents, PressCarriesTheSlaveTime) {
+    run(10 - timer_read() % 10, 1000);  // line up with the master's 10 ms cadence
+    run(3, 1000);
+    uint16_t pressed_at       = timer_read() + 1;  // seen by the next slave scan
+    split_sim_slave.matrix[1] = 0x04;
+    run(7, 10);
+
+    ASSERT_EQ(split_sim_master.remote[1], 0x04);
+    EXPECT_EQ(key_time(SLAVE_ROW(1), 2), pressed_at | 1);
+    // Keys of the master half, and slave keys that did not change, get the scan time
+    EXPECT_EQ(key_time(1, 2), timer_read());
+    EXPECT_EQ(key_time(SLAVE_ROW(1), 3), timer_read());
+}
+
+TEST_F(SplitKeyEvents, ShortTapKeepsBothEdges) {
+    run(10 - timer_read() % 10, 1000);
+    run(2, 1000);
+    uint16_t pressed_at       = timer_read() + 1;
+    split_sim_slave.matrix[0] = 0x01;
+    run(3, 1000);
+    uint16_t released_at      = timer_read() + 1;
+    split_sim_slave.matrix[0] = 0;
+    run(5, 10);
+
+    // Both edges happened between two master scans, they come one scan apart
+    EXPECT_EQ(split_sim_master.remote[0], 0x01);
+    EXPECT_EQ(key_time(SLAVE_ROW(0), 0), pressed_at | 1);
+
+    run(10, 10);
+    EXPECT_EQ(split_sim_master.remote[0], 0);
+    EXPECT_EQ(key_time(SLAVE_ROW(0), 0), released_at | 1);
+}
+
+TEST_F(SplitKeyEvents, EventsNeverGoBackInTime) {
+    run(10 - timer_read() % 10, 1000);
+    run(6, 1000);
+    uint16_t slave_pressed_at = timer_read() + 1;
+    split_sim_slave.matrix[0] = 0x01;
+    run(3, 1000);
+
+    // The slave edge misses the master scan where a mod-tap on the master half goes down
+    split_sim_faults.disconnected = true;
+    run(10 - timer_read() % 10, 10);
+    split_sim_faults.disconnected = false;
+    uint16_t mod_tap_time         = key_time(1, 2);
+
+    // The older slave edge comes next, it must not go back before the mod-tap press
+    run(10, 10);
+    ASSERT_EQ(split_sim_master.remote[0], 0x01);
+    uint16_t slave_time = key_time(SLAVE_ROW(0), 0);
+    EXPECT_NE(slave_time, slave_pressed_at | 1);
+    EXPECT_EQ(slave_time, mod_tap_time);
+    EXPECT_LT(TIMER_DIFF_16(slave_time, mod_tap_time), 10);
+
+    // Later edges keep their own time
+    run(2, 1000);
+    uint16_t released_at      = timer_read() + 1;
+    split_sim_slave.matrix[0] = 0;
+    run(10, 10);
+    EXPECT_EQ(key_time(SLAVE_ROW(0), 0), released_at | 1);
+}
+
+TEST_F(SplitKeyEvents, OverflowFallsBackToTheRows) {
+    // More edges than the slave queue holds, while the master is away
+    split_sim_faults.disconnected = true;
+    for (int i = 0; i < SPLIT_KEY_EVENTS_QUEUE_SIZE + 5; i++) {
+        split_sim_slave.matrix[2] ^= 0x10;
+        run(2, 1000);
+    }
+    split_sim_slave.matrix[3] = 0x80;
+    run(2, 1000);
+    split_sim_faults.disconnected = false;
+
+    run(20, 5);
+    for (int row = 0; row < SPLIT_SIM_ROWS; row++) {
+        EXPECT_EQ(split_sim_master.remote[row], split_sim_slave.matrix[row]);
+    }
+
+    // and the events that follow are exact again
+    uint16_t pressed_at       = timer_read() + 1;
+    split_sim_slave.matrix[0] = 0x02;
+    run(5, 5);
+    EXPECT_EQ(split_sim_master.remote[0], 0x02);
+    EXPECT_EQ(key_time(SLAVE_ROW(0), 1), pressed_at | 1);
+}
+
+TEST_F(SplitKeyEvents, NoEdgeIsLostToDroppedBytes) {
+    split_sim_faults.drop_every = 7;
+    for (int i = 0; i < 50; i++) {
+        split_sim_slave.matrix[i % SPLIT_SIM_ROWS] ^= 1 << (i % 5);
+        run(3, 4);
+    }
+    split_sim_faults.drop_every = 0;
+    run(100, 4);
+
+    EXPECT_GT(split_sim_counters.errors, 0u);
+    EXPECT_EQ(edges, 50);
+    for (int row = 0; row < SPLIT_SIM_ROWS; row++) {
+        EXPECT_EQ(split_sim_master.remote[row], split_sim_slave.matrix[row]);
+    }
+}
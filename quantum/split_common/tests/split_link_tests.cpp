@@ -0,0 +1,162 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "split_sim.h"
+#include "serial.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+#define SLOWEST_SPEED (SOFT_SERIAL_SPEED_COUNT - 1)
+
+class SplitLink : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+        split_sim_init();
+    }
+
+    // Scans once per millisecond, returns how many scans failed
+    int scan_for(uint32_t ms) {
+        int failed = 0;
+        for (uint32_t i = 0; i < ms; i++) {
+            if (!split_sim_scan()) failed++;
+            advance_time(1);
+        }
+        return failed;
+    }
+
+    // The counters of all transaction ids added up
+    split_link_stats_t totals(void) {
+        split_link_stats_t sum = {0, 0, 0, 0};
+        for (uint8_t id = 0; id < SPLIT_LINK_STATS_COUNT; id++) {
+            const split_link_stats_t *entry = master_split_link_stats(id);
+            sum.success += entry->success;
+            sum.timeout += entry->timeout;
+            sum.checksum += entry->checksum;
+            sum.failure += entry->failure;
+        }
+        return sum;
+    }
+};
+
+TEST_F(SplitLink, CleanLinkCountsSuccesses) {
+    scan_for(200);
+    split_link_stats_t sum = totals();
+    EXPECT_EQ(sum.success, split_sim_counters.transactions);
+    EXPECT_EQ(sum.timeout, 0);
+    EXPECT_EQ(sum.checksum, 0);
+    EXPECT_EQ(sum.failure, 0);
+}
+
+TEST_F(SplitLink, FlippedBitsCountAsChecksumErrors) {
+    split_sim_faults.flip_every = 7;
+    scan_for(200);
+    split_link_stats_t sum = totals();
+    EXPECT_GT(sum.checksum, 0);
+    EXPECT_EQ(sum.checksum, split_sim_counters.errors);
+    EXPECT_EQ(sum.timeout, 0);
+    EXPECT_EQ(sum.success + sum.checksum, split_sim_counters.transactions);
+}
+
+TEST_F(SplitLink, DroppedBytesCountAsTimeouts) {
+    split_sim_faults.drop_every = 7;
+    scan_for(200);
+    split_link_stats_t sum = totals();
+    EXPECT_GT(sum.timeout, 0);
+    EXPECT_EQ(sum.timeout, split_sim_counters.errors);
+    EXPECT_EQ(sum.checksum, 0);
+    EXPECT_EQ(sum.success + sum.timeout, split_sim_counters.transactions);
+}
+
+TEST_F(SplitLink, CountersAreKeptPerTransaction) {
+    scan_for(50);
+    split_sim_faults.disconnected = true;
+    scan_for(50);
+
+    // Transaction 0 runs on every scan with both transports
+    const split_link_stats_t *first = master_split_link_stats(0);
+    EXPECT_GT(first->success, 0);
+    EXPECT_GT(first->timeout, 0);
+    EXPECT_EQ(master_split_link_stats(SPLIT_LINK_STATS_COUNT), nullptr);
+
+    master_split_link_stats_reset();
+    EXPECT_EQ(first->success, 0);
+    EXPECT_EQ(first->timeout, 0);
+}
+
+#ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+
+// Enough scans for a few error-free windows, whatever the transactions per scan
+#    define WINDOWS_TIME (4 * SOFT_SERIAL_ADAPTIVE_SPEED_WINDOW)
+
+TEST_F(SplitLink, CleanLinkSpeedsUp) {
+    ASSERT_EQ(master_soft_serial_get_speed(), SELECT_SOFT_SERIAL_SPEED);
+    scan_for(WINDOWS_TIME);
+    EXPECT_EQ(master_soft_serial_get_speed(), SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST);
+    EXPECT_EQ(slave_soft_serial_get_speed(), SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST);
+    EXPECT_EQ(scan_for(100), 0);
+}
+
+TEST_F(SplitLink, NoisyLinkSlowsDownUntilRecovery) {
+    scan_for(WINDOWS_TIME);
+    ASSERT_EQ(master_soft_serial_get_speed(), SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST);
+
+    // Noise at the fastest speed only, gone as soon as the link slows down
+    split_sim_faults.flip_every = 20;
+    uint32_t slowed_at          = timer_read32();
+    for (int i = 0; i < WINDOWS_TIME && master_soft_serial_get_speed() == SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST; i++) {
+        scan_for(1);
+        slowed_at = timer_read32();
+    }
+    split_sim_faults.flip_every = 0;
+    scan_for(10);
+    EXPECT_EQ(master_soft_serial_get_speed(), SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST + 1);
+    EXPECT_EQ(slave_soft_serial_get_speed(), SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST + 1);
+
+    // A clean link does not try the failed speed again right away
+    scan_for(SOFT_SERIAL_ADAPTIVE_SPEED_RECOVERY - WINDOWS_TIME - timer_elapsed32(slowed_at));
+    EXPECT_EQ(master_soft_serial_get_speed(), SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST + 1);
+
+    // but does once it stayed clean long enough
+    scan_for(2 * WINDOWS_TIME);
+    EXPECT_EQ(master_soft_serial_get_speed(), SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST);
+    EXPECT_EQ(slave_soft_serial_get_speed(), SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST);
+    EXPECT_EQ(scan_for(100), 0);
+}
+
+TEST_F(SplitLink, LostLinkFallsBackToSlowest) {
+    scan_for(WINDOWS_TIME);
+    split_sim_faults.disconnected = true;
+    scan_for(2 * SOFT_SERIAL_ADAPTIVE_SPEED_TIMEOUT);
+    EXPECT_EQ(master_soft_serial_get_speed(), SLOWEST_SPEED);
+    EXPECT_EQ(slave_soft_serial_get_speed(), SLOWEST_SPEED);
+
+    // Both halves meet at the slowest speed, then climb back one step per clean window
+    split_sim_faults.disconnected = false;
+    EXPECT_EQ(scan_for(10), 0);
+    scan_for(WINDOWS_TIME);
+    EXPECT_LT(master_soft_serial_get_speed(), SLOWEST_SPEED);
+    scan_for(SLOWEST_SPEED * WINDOWS_TIME);
+    EXPECT_EQ(master_soft_serial_get_speed(), SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST);
+    EXPECT_EQ(slave_soft_serial_get_speed(), SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST);
+}
+
+#endif
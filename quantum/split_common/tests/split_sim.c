@@ -0,0 +1,264 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "split_sim.h"
+#include "timer.h"
+
+#ifdef USE_I2C
+#    include "i2c_master.h"
+#    include "i2c_slave.h"
+#else
+#    include "serial.h"
+#endif
+
+void advance_time(uint32_t ms);
+
+split_sim_faults_t   split_sim_faults;
+split_sim_counters_t split_sim_counters;
+split_sim_half_t     split_sim_master;
+split_sim_half_t     split_sim_slave;
+
+// The master is the left half, its rows come first
+volatile bool master_isLeftHand = true;
+volatile bool slave_isLeftHand  = false;
+
+#ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+static uint8_t master_speed = SELECT_SOFT_SERIAL_SPEED;
+static uint8_t slave_speed  = SELECT_SOFT_SERIAL_SPEED;
+
+// The bitbang drivers' runtime speed, one per half
+#    define SPLIT_SIM_SPEED(half)                                                                  \
+        void half##_soft_serial_set_speed(uint8_t speed) {                                         \
+            if (speed < SOFT_SERIAL_SPEED_COUNT) half##_speed = speed;                             \
+        }                                                                                          \
+        uint8_t half##_soft_serial_get_speed(void) { return half##_speed; }
+
+SPLIT_SIM_SPEED(master)
+SPLIT_SIM_SPEED(slave)
+#endif
+
+/** \brief Resets the channel and both halves, then starts their transports
+ */
+void split_sim_init(void) {
+    memset(&split_sim_faults, 0, sizeof(split_sim_faults));
+    memset(&split_sim_counters, 0, sizeof(split_sim_counters));
+    memset(&split_sim_master, 0, sizeof(split_sim_master));
+    memset(&split_sim_slave, 0, sizeof(split_sim_slave));
+#ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    master_speed = SELECT_SOFT_SERIAL_SPEED;
+    slave_speed  = SELECT_SOFT_SERIAL_SPEED;
+#endif
+    master_reset();
+    slave_reset();
+
+    slave_transport_slave_init();
+    master_transport_master_init();
+}
+
+/** \brief One scan of the slave: it publishes its state, and picks up what the master sent
+ */
+void split_sim_slave_scan(void) {
+#ifdef SPLIT_KEY_EVENTS
+    slave_split_key_events_record(split_sim_slave.matrix);
+#endif
+    slave_transport_slave(split_sim_slave.remote, split_sim_slave.matrix);
+}
+
+/** \brief One scan of the master, returns what transport_master() returned
+ */
+bool split_sim_master_scan(void) {
+    matrix_row_t received[SPLIT_SIM_ROWS] = {0};
+    bool         ok                       = master_transport_master(split_sim_master.matrix, received);
+    if (ok) {
+        memcpy(split_sim_master.remote, received, sizeof(received));
+    }
+    return ok;
+}
+
+/** \brief One scan of both halves, the slave first
+ */
+bool split_sim_scan(void) {
+    split_sim_slave_scan();
+    return split_sim_master_scan();
+}
+
+// Per-half state behind the hooks transport.c calls
+#define SPLIT_SIM_HOOKS(half)                                                          \
+    uint8_t half##_get_mods(void) { return split_sim_##half.mods; }                    \
+    void    half##_set_mods(uint8_t mods) { split_sim_##half.mods = mods; }            \
+    uint8_t half##_get_weak_mods(void) { return split_sim_##half.weak_mods; }          \
+    void    half##_set_weak_mods(uint8_t mods) { split_sim_##half.weak_mods = mods; }  \
+    uint8_t half##_get_oneshot_mods(void) { return split_sim_##half.oneshot_mods; }    \
+    void    half##_set_oneshot_mods(uint8_t mods) { split_sim_##half.oneshot_mods = mods; }
+
+SPLIT_SIM_HOOKS(master)
+SPLIT_SIM_HOOKS(slave)
+
+// Which byte of the transaction a fault hits, and which of its bits
+static bool fault_due(uint16_t every) { return every && split_sim_counters.transactions % every == 0; }
+
+static uint8_t fault_byte(uint16_t size) { return size ? split_sim_counters.transactions % size : 0; }
+
+static uint8_t fault_bit(void) { return 1 << (split_sim_counters.transactions % 8); }
+
+#ifdef USE_I2C
+
+volatile uint8_t master_i2c_slave_reg[I2C_SLAVE_REG_COUNT];
+volatile uint8_t slave_i2c_slave_reg[I2C_SLAVE_REG_COUNT];
+
+static uint8_t slave_address;
+
+void i2c_init(void) {}
+
+void i2c_slave_init(uint8_t address) { slave_address = address; }
+
+/* Copies length bytes over the bus, faults included. I2C has no checksum: a
+ * flipped bit goes through unnoticed, a dropped byte ends the transfer.
+ */
+static i2c_status_t i2c_transfer(uint8_t devaddr, volatile uint8_t *to, const volatile uint8_t *from, uint16_t length, uint8_t overhead) {
+    split_sim_counters.transactions++;
+    advance_time(split_sim_faults.latency);
+    if (split_sim_faults.disconnected || devaddr != slave_address) {
+        split_sim_counters.errors++;
+        return I2C_STATUS_TIMEOUT;
+    }
+
+    bool    drop = fault_due(split_sim_faults.drop_every);
+    bool    flip = fault_due(split_sim_faults.flip_every);
+    uint8_t hit  = fault_byte(length);
+    split_sim_counters.bytes += overhead;
+    for (uint16_t i = 0; i < length; i++) {
+        if (drop && i == hit) {
+            split_sim_counters.errors++;
+            return I2C_STATUS_TIMEOUT;
+        }
+        to[i] = (flip && i == hit) ? from[i] ^ fault_bit() : from[i];
+        split_sim_counters.bytes++;
+    }
+    if (flip && length) split_sim_counters.errors++;
+    return I2C_STATUS_SUCCESS;
+}
+
+// address and register, then the address again to read
+i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t *data, uint16_t length, uint16_t timeout) {
+    if (regaddr + length > I2C_SLAVE_REG_COUNT) return I2C_STATUS_ERROR;
+    return i2c_transfer(devaddr, data, &slave_i2c_slave_reg[regaddr], length, 3);
+}
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    if (regaddr + length > I2C_SLAVE_REG_COUNT) return I2C_STATUS_ERROR;
+    return i2c_transfer(devaddr, &slave_i2c_slave_reg[regaddr], data, length, 2);
+}
+
+#else
+
+static SSTD_t *initiator_table;
+static SSTD_t *target_table;
+static int     table_size;
+
+void soft_serial_initiator_init(SSTD_t *sstd_table, int sstd_table_size) {
+    initiator_table = sstd_table;
+    table_size      = sstd_table_size;
+}
+
+void soft_serial_target_init(SSTD_t *sstd_table, int sstd_table_size) {
+    target_table = sstd_table;
+    // Nothing was accepted since power up, whatever the previous test left there
+    for (int i = 0; i < sstd_table_size; i++) {
+        if (sstd_table[i].status) *sstd_table[i].status = 0;
+    }
+}
+
+/* Runs a transaction the way the bitbang driver does: the master payload
+ * and its checksum, then the slave payload and its checksum. The receiving
+ * side writes into its buffer as the bytes arrive, so a fault leaves part
+ * of the new payload there. A dropped byte stalls the line, a flipped bit
+ * fails the checksum.
+ */
+static int serial_transfer(int index) {
+    split_sim_counters.transactions++;
+    advance_time(split_sim_faults.latency);
+    if (split_sim_faults.disconnected || !target_table || index >= table_size) {
+        split_sim_counters.errors++;
+        return TRANSACTION_NO_RESPONSE;
+    }
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    // The slave does not make sense of pulses at another speed
+    if (master_speed != slave_speed) {
+        split_sim_counters.errors++;
+        return TRANSACTION_NO_RESPONSE;
+    }
+#    endif
+
+    SSTD_t *master = &initiator_table[index];
+    SSTD_t *slave  = &target_table[index];
+    bool    drop   = fault_due(split_sim_faults.drop_every);
+    bool    flip   = fault_due(split_sim_faults.flip_every);
+    uint8_t hit    = fault_byte(master->initiator2target_buffer_size + master->target2initiator_buffer_size);
+
+#    ifdef SERIAL_USE_MULTI_TRANSACTION
+    split_sim_counters.bytes++;  // transaction id
+#    endif
+
+    for (uint8_t i = 0; i < master->initiator2target_buffer_size; i++) {
+        if (drop && i == hit) {
+            *slave->status = TRANSACTION_DATA_ERROR;
+            split_sim_counters.errors++;
+            return TRANSACTION_NO_RESPONSE;
+        }
+        uint8_t byte                      = master->initiator2target_buffer[i];
+        slave->initiator2target_buffer[i] = (flip && i == hit) ? byte ^ fault_bit() : byte;
+        split_sim_counters.bytes++;
+    }
+    split_sim_counters.bytes++;  // checksum
+    bool corrupted = flip && hit < master->initiator2target_buffer_size;
+
+    for (uint8_t i = 0; i < master->target2initiator_buffer_size; i++) {
+        uint8_t at = master->initiator2target_buffer_size + i;
+        if (drop && at == hit) {
+            *slave->status = corrupted ? TRANSACTION_DATA_ERROR : TRANSACTION_ACCEPTED;
+            split_sim_counters.errors++;
+            return TRANSACTION_NO_RESPONSE;
+        }
+        uint8_t byte                       = slave->target2initiator_buffer[i];
+        master->target2initiator_buffer[i] = (flip && at == hit) ? byte ^ fault_bit() : byte;
+        split_sim_counters.bytes++;
+    }
+    split_sim_counters.bytes++;  // checksum
+
+    *slave->status = corrupted ? TRANSACTION_DATA_ERROR : TRANSACTION_ACCEPTED;
+    if (flip && (master->initiator2target_buffer_size || master->target2initiator_buffer_size)) {
+        split_sim_counters.errors++;
+        return TRANSACTION_DATA_ERROR;
+    }
+    return TRANSACTION_END;
+}
+
+#    ifndef SERIAL_USE_MULTI_TRANSACTION
+int soft_serial_transaction(void) { return serial_transfer(0); }
+#    else
+int soft_serial_transaction(int sstd_index) { return serial_transfer(sstd_index); }
+
+int soft_serial_get_and_clean_status(int sstd_index) {
+    int status                           = *target_table[sstd_index].status;
+    *target_table[sstd_index].status = 0;
+    return status;
+}
+#    endif
+
+#endif
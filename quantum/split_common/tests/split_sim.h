@@ -0,0 +1,103 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "config.h"
+#include "matrix.h"
+#ifdef SPLIT_LINK_STATS
+#    include "split_link.h"
+#endif
+
+/* Loopback simulator for the split transport.
+ *
+ * Both halves of a keyboard run in the same process: split_sim_master.c and
+ * split_sim_slave.c each compile their own copy of the transport, and the
+ * soft_serial_*() and i2c_*() calls of the two copies meet in an in-memory
+ * channel here. The channel counts what goes over the wire and can slow
+ * down, drop bytes from, or flip bits in the transactions. With
+ * SOFT_SERIAL_ADAPTIVE_SPEED each half has its own serial speed, and a
+ * transaction between halves at different speeds gets no answer.
+ */
+
+#define SPLIT_SIM_ROWS (MATRIX_ROWS / 2)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint16_t latency;       // milliseconds each transaction takes
+    uint16_t drop_every;    // every nth transaction loses a byte, 0 for never
+    uint16_t flip_every;    // every nth transaction gets a bit flipped, 0 for never
+    bool     disconnected;  // the slave does not answer at all
+} split_sim_faults_t;
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t bytes;   // on the wire, both directions
+    uint32_t errors;  // transactions that lost or corrupted data
+} split_sim_counters_t;
+
+typedef struct {
+    matrix_row_t matrix[SPLIT_SIM_ROWS];  // the half's own keys
+    matrix_row_t remote[SPLIT_SIM_ROWS];  // the other half's keys, as received
+    uint8_t      mods;
+    uint8_t      weak_mods;
+    uint8_t      oneshot_mods;
+} split_sim_half_t;
+
+extern split_sim_faults_t   split_sim_faults;
+extern split_sim_counters_t split_sim_counters;
+extern split_sim_half_t     split_sim_master;
+extern split_sim_half_t     split_sim_slave;
+
+void split_sim_init(void);
+void split_sim_slave_scan(void);
+bool split_sim_master_scan(void);
+bool split_sim_scan(void);
+
+// The two copies of the transport
+void master_transport_master_init(void);
+bool master_transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+void slave_transport_slave_init(void);
+void slave_transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+// Each half back to its state after power up
+void master_reset(void);
+void slave_reset(void);
+
+#ifdef SPLIT_LINK_STATS
+const split_link_stats_t *master_split_link_stats(uint8_t transaction_id);
+void                      master_split_link_stats_reset(void);
+#endif
+
+#ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+uint8_t master_soft_serial_get_speed(void);
+uint8_t slave_soft_serial_get_speed(void);
+#endif
+
+#ifdef SPLIT_KEY_EVENTS
+void     slave_split_key_events_record(const matrix_row_t rows[]);
+uint16_t master_split_key_events_time(uint8_t row, uint8_t col, uint16_t scan_time);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
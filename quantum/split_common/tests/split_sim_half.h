@@ -0,0 +1,70 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* Compiles the transport into one half of the simulated keyboard.
+ *
+ * Every symbol the two halves would both define, and every hook that
+ * reads or writes per-half state, gets the SPLIT_SIM_HALF() prefix, so
+ * the master and the slave each get their own copy of transport.c and
+ * transactions.c in the same test binary.
+ */
+
+#define transport_master_init SPLIT_SIM_HALF(transport_master_init)
+#define transport_slave_init SPLIT_SIM_HALF(transport_slave_init)
+#define transport_master SPLIT_SIM_HALF(transport_master)
+#define transport_slave SPLIT_SIM_HALF(transport_slave)
+
+#define split_transaction_register SPLIT_SIM_HALF(split_transaction_register)
+#define split_transaction_request SPLIT_SIM_HALF(split_transaction_request)
+#define split_transactions_master_init SPLIT_SIM_HALF(split_transactions_master_init)
+#define split_transactions_slave_init SPLIT_SIM_HALF(split_transactions_slave_init)
+#define split_transactions_master SPLIT_SIM_HALF(split_transactions_master)
+#define split_transactions_slave SPLIT_SIM_HALF(split_transactions_slave)
+
+#define serial_s2m_buffer SPLIT_SIM_HALF(serial_s2m_buffer)
+#define serial_m2s_buffer SPLIT_SIM_HALF(serial_m2s_buffer)
+#define status0 SPLIT_SIM_HALF(status0)
+#define transactions SPLIT_SIM_HALF(transactions)
+#define i2c_slave_reg SPLIT_SIM_HALF(i2c_slave_reg)
+#define isLeftHand SPLIT_SIM_HALF(isLeftHand)
+
+#define split_key_events_record SPLIT_SIM_HALF(split_key_events_record)
+#define split_key_events_fill SPLIT_SIM_HALF(split_key_events_fill)
+#define split_key_events_ack SPLIT_SIM_HALF(split_key_events_ack)
+#define split_key_events_apply SPLIT_SIM_HALF(split_key_events_apply)
+#define split_key_events_next_seq SPLIT_SIM_HALF(split_key_events_next_seq)
+#define split_key_events_time SPLIT_SIM_HALF(split_key_events_time)
+
+#define split_link_record SPLIT_SIM_HALF(split_link_record)
+#define split_link_stats SPLIT_SIM_HALF(split_link_stats)
+#define split_link_stats_reset SPLIT_SIM_HALF(split_link_stats_reset)
+#define split_link_stats_print SPLIT_SIM_HALF(split_link_stats_print)
+#define split_link_stats_raw_hid SPLIT_SIM_HALF(split_link_stats_raw_hid)
+#define split_link_requested_speed SPLIT_SIM_HALF(split_link_requested_speed)
+#define split_link_master_task SPLIT_SIM_HALF(split_link_master_task)
+#define split_link_speed_sent SPLIT_SIM_HALF(split_link_speed_sent)
+#define split_link_slave_received SPLIT_SIM_HALF(split_link_slave_received)
+#define split_link_slave_task SPLIT_SIM_HALF(split_link_slave_task)
+#define soft_serial_set_speed SPLIT_SIM_HALF(soft_serial_set_speed)
+#define soft_serial_get_speed SPLIT_SIM_HALF(soft_serial_get_speed)
+
+#define get_mods SPLIT_SIM_HALF(get_mods)
+#define set_mods SPLIT_SIM_HALF(set_mods)
+#define get_weak_mods SPLIT_SIM_HALF(get_weak_mods)
+#define set_weak_mods SPLIT_SIM_HALF(set_weak_mods)
+#define get_oneshot_mods SPLIT_SIM_HALF(get_oneshot_mods)
+#define set_oneshot_mods SPLIT_SIM_HALF(set_oneshot_mods)
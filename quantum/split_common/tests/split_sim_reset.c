@@ -0,0 +1,44 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Included by split_sim_master.c and split_sim_slave.c after the transport,
+ * to reach the static state of their half.
+ */
+
+// Back to the state after power up, between tests
+void SPLIT_SIM_HALF(reset)(void) {
+#ifdef SPLIT_KEY_EVENTS
+    memset(queue, 0, sizeof(queue));
+    memset(recorded, 0, sizeof(recorded));
+    memset(applied_rows, 0, sizeof(applied_rows));
+    queue_head    = 0;
+    queue_count   = 0;
+    queue_seq     = 0;
+    applied_count = 0;
+    next_seq      = 0;
+    last_time     = 0;
+#endif
+#ifdef SPLIT_LINK_STATS
+    split_link_stats_reset();
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    requested_speed = SELECT_SOFT_SERIAL_SPEED;
+    fastest_speed   = SOFT_SERIAL_ADAPTIVE_SPEED_FASTEST;
+    last_success    = timer_read();
+    last_slowdown   = 0;
+    restart_window();
+#    endif
+#endif
+}
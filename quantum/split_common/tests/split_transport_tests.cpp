@@ -0,0 +1,220 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+extern "C" {
+#include "split_sim.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+#ifdef USE_I2C
+#    define TRANSPORT_NAME "i2c"
+#elif defined(SPLIT_TRANSPORT_DELTA)
+#    define TRANSPORT_NAME "serial delta"
+#else
+#    define TRANSPORT_NAME "serial"
+#endif
+
+// Longest a resync may take: the delta transport resends everything on the next keyframe
+#define RESYNC_TIME 600
+
+class SplitTransport : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+        split_sim_init();
+        scan_for(RESYNC_TIME);
+    }
+
+    // Scans once per millisecond, returns how many scans failed
+    int scan_for(uint32_t ms) {
+        int failed = 0;
+        for (uint32_t i = 0; i < ms; i++) {
+            if (!split_sim_scan()) failed++;
+            advance_time(1);
+        }
+        return failed;
+    }
+
+    void expect_in_sync(void) {
+        for (int row = 0; row < SPLIT_SIM_ROWS; row++) {
+            EXPECT_EQ(split_sim_master.remote[row], split_sim_slave.matrix[row]) << "slave row " << row;
+#ifdef SPLIT_TRANSPORT_MIRROR
+            EXPECT_EQ(split_sim_slave.remote[row], split_sim_master.matrix[row]) << "master row " << row;
+#endif
+        }
+        EXPECT_EQ(split_sim_slave.mods, split_sim_master.mods);
+        EXPECT_EQ(split_sim_slave.weak_mods, split_sim_master.weak_mods);
+        EXPECT_EQ(split_sim_slave.oneshot_mods, split_sim_master.oneshot_mods);
+    }
+
+    // Presses and releases keys on both halves and changes the mods, the way typing does
+    void type(int strokes) {
+        for (int i = 0; i < strokes; i++) {
+            split_sim_slave.matrix[i % SPLIT_SIM_ROWS] ^= 1 << (i % MATRIX_COLS);
+            split_sim_master.matrix[(i + 1) % SPLIT_SIM_ROWS] ^= 1 << ((i * 3) % MATRIX_COLS);
+            if (i % 4 == 0) split_sim_master.mods ^= 1 << (i % 8);
+            scan_for(7);
+        }
+    }
+};
+
+TEST_F(SplitTransport, SlaveKeysReachTheMaster) {
+    split_sim_slave.matrix[2] = 0x81;
+    EXPECT_EQ(scan_for(1), 0);
+    EXPECT_EQ(split_sim_master.remote[2], 0x81);
+
+    split_sim_slave.matrix[2] = 0;
+    EXPECT_EQ(scan_for(1), 0);
+    EXPECT_EQ(split_sim_master.remote[2], 0);
+}
+
+#ifdef SPLIT_TRANSPORT_MIRROR
+TEST_F(SplitTransport, MasterKeysAreMirroredToTheSlave) {
+    split_sim_master.matrix[1] = 0x10;
+    // The serial transport fills in the master rows after its exchange, they go out on the next one
+    scan_for(3);
+    EXPECT_EQ(split_sim_slave.remote[1], 0x10);
+}
+#endif
+
+TEST_F(SplitTransport, ModsReachTheSlave) {
+    split_sim_master.mods         = 0x02;
+    split_sim_master.weak_mods    = 0x20;
+    split_sim_master.oneshot_mods = 0x04;
+    EXPECT_EQ(scan_for(RESYNC_TIME), 0);
+    expect_in_sync();
+}
+
+TEST_F(SplitTransport, ResyncsAfterFlippedBits) {
+    split_sim_faults.flip_every = 3;
+    type(100);
+    EXPECT_GT(split_sim_counters.errors, 0u);
+
+    split_sim_faults.flip_every = 0;
+    scan_for(RESYNC_TIME);
+#ifdef USE_I2C
+    // No checksum: a corrupted write is cached by the master as delivered,
+    // only the slave matrix, read back every scan, is guaranteed to recover.
+    for (int row = 0; row < SPLIT_SIM_ROWS; row++) {
+        EXPECT_EQ(split_sim_master.remote[row], split_sim_slave.matrix[row]);
+    }
+#else
+    expect_in_sync();
+#endif
+}
+
+TEST_F(SplitTransport, ResyncsAfterDroppedBytes) {
+    split_sim_faults.drop_every = 5;
+    type(100);
+    EXPECT_GT(split_sim_counters.errors, 0u);
+
+    split_sim_faults.drop_every = 0;
+    scan_for(RESYNC_TIME);
+#ifdef USE_I2C
+    for (int row = 0; row < SPLIT_SIM_ROWS; row++) {
+        EXPECT_EQ(split_sim_master.remote[row], split_sim_slave.matrix[row]);
+    }
+#else
+    expect_in_sync();
+#endif
+}
+
+TEST_F(SplitTransport, CatchesUpAfterDisconnect) {
+    split_sim_faults.disconnected = true;
+    split_sim_master.mods         = 0x40;
+    split_sim_slave.matrix[0]     = 0x01;
+    split_sim_master.matrix[3]    = 0x08;
+#ifndef USE_I2C
+    EXPECT_EQ(scan_for(50), 50);
+#else
+    scan_for(50);
+#endif
+    EXPECT_EQ(split_sim_slave.mods, 0);
+
+    split_sim_faults.disconnected = false;
+    scan_for(RESYNC_TIME);
+    expect_in_sync();
+}
+
+TEST_F(SplitTransport, SurvivesLatency) {
+    split_sim_faults.latency = 2;
+    type(20);
+    scan_for(RESYNC_TIME);
+    expect_in_sync();
+}
+
+#ifdef SPLIT_TRANSPORT_DELTA
+TEST_F(SplitTransport, IdleScanOnlyPollsTheSlaveVersion) {
+    uint32_t bytes = split_sim_counters.bytes;
+    scan_for(1);
+    // id, empty master payload checksum, version byte and its checksum
+    EXPECT_EQ(split_sim_counters.bytes - bytes, 4u);
+}
+
+TEST_F(SplitTransport, ErrorTriggersAKeyframe) {
+    split_sim_faults.drop_every = 1;
+    EXPECT_EQ(scan_for(1), 1);
+    split_sim_faults.drop_every = 0;
+
+    // Everything goes again on the next scan, not only the version poll
+    uint32_t transactions = split_sim_counters.transactions;
+    EXPECT_EQ(scan_for(1), 0);
+    EXPECT_GT(split_sim_counters.transactions - transactions, 1u);
+}
+#endif
+
+#ifdef USE_I2C
+TEST_F(SplitTransport, IdleScanIsOneBurstRead) {
+    uint32_t transactions = split_sim_counters.transactions;
+    uint32_t bytes        = split_sim_counters.bytes;
+    scan_for(1);
+    EXPECT_EQ(split_sim_counters.transactions - transactions, 1u);
+    // address, register, address again and the slave rows
+    EXPECT_EQ(split_sim_counters.bytes - bytes, 3u + SPLIT_SIM_ROWS);
+}
+
+TEST_F(SplitTransport, OnlyTheChangedRangeIsWritten) {
+    split_sim_master.weak_mods = 0x20;
+    uint32_t transactions      = split_sim_counters.transactions;
+    uint32_t bytes             = split_sim_counters.bytes;
+    scan_for(1);
+    EXPECT_EQ(split_sim_counters.transactions - transactions, 2u);
+    // the read, then address, register and the weak mods byte
+    EXPECT_EQ(split_sim_counters.bytes - bytes, 3u + SPLIT_SIM_ROWS + 2u + 1u);
+    // the slave picks them up on its next scan
+    scan_for(1);
+    expect_in_sync();
+}
+#endif
+
+// Not a pass/fail test: prints the cost of the transport, to compare changes
+TEST_F(SplitTransport, Benchmark) {
+    uint32_t bytes        = split_sim_counters.bytes;
+    uint32_t transactions = split_sim_counters.transactions;
+    scan_for(1000);
+    printf("[ BENCH    ] " TRANSPORT_NAME ": idle %.2f bytes/scan, %.2f transactions/scan\n", (split_sim_counters.bytes - bytes) / 1000.0, (split_sim_counters.transactions - transactions) / 1000.0);
+
+    bytes        = split_sim_counters.bytes;
+    transactions = split_sim_counters.transactions;
+    type(143);  // 1001 scans
+    printf("[ BENCH    ] " TRANSPORT_NAME ": typing %.2f bytes/scan, %.2f transactions/scan\n", (split_sim_counters.bytes - bytes) / 1001.0, (split_sim_counters.transactions - transactions) / 1001.0);
+}
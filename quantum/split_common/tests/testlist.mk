@@ -0,0 +1,25 @@
+# Copyright 2021 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+TEST_LIST +=\
+	split_transport_serial\
+	split_transport_delta\
+	split_transport_i2c\
+	split_key_events_serial\
+	split_key_events_delta\
+	split_link_stats_serial\
+	split_link_stats_delta\
+	split_link_speed_serial\
+	split_link_speed_delta
@@ -0,0 +1,140 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+
+#include "transactions.h"
+#include "serial.h"
+#include "timer.h"
+#include "split_link.h"
+
+#if !defined(USE_I2C) && defined(SPLIT_TRANSPORT_DELTA)
+
+// The AVR soft serial driver sends the transaction id in 4 bits
+_Static_assert(SPLIT_TRANSACTION_COUNT <= 16, "Too many split transactions, lower SPLIT_TRANSACTION_USER_COUNT");
+
+static const split_transaction_t *registry[SPLIT_TRANSACTION_COUNT];
+static SSTD_t                     sstd_table[SPLIT_TRANSACTION_COUNT];
+static uint8_t volatile           status[SPLIT_TRANSACTION_COUNT];
+static uint16_t                   last_run[SPLIT_TRANSACTION_COUNT];
+static uint16_t                   pending       = 0;
+static bool                       keyframe_due  = true;
+static uint16_t                   keyframe_time = 0;
+
+#    define ID_BIT(id) ((uint16_t)1 << (id))
+
+/** \brief Adds or replaces the transaction with the given id
+ */
+void split_transaction_register(uint8_t id, const split_transaction_t *transaction) {
+    if (id >= SPLIT_TRANSACTION_COUNT) return;
+
+    registry[id]   = transaction;
+    sstd_table[id] = (SSTD_t){
+        (uint8_t *)&status[id], transaction->initiator2target_buffer_size, transaction->initiator2target_buffer, transaction->target2initiator_buffer_size, transaction->target2initiator_buffer,
+    };
+    pending |= ID_BIT(id);
+}
+
+/** \brief Runs the transaction as soon as its interval allows
+ */
+void split_transaction_request(uint8_t id) {
+    if (id < SPLIT_TRANSACTION_COUNT) pending |= ID_BIT(id);
+}
+
+static void split_transactions_init(void) {
+    // Unregistered ids still need a status, in case the other half knows them
+    for (uint8_t id = 0; id < SPLIT_TRANSACTION_COUNT; id++) {
+        if (!registry[id]) sstd_table[id].status = (uint8_t *)&status[id];
+    }
+}
+
+void split_transactions_master_init(void) {
+    split_transactions_init();
+    soft_serial_initiator_init(sstd_table, SPLIT_TRANSACTION_COUNT);
+}
+
+void split_transactions_slave_init(void) {
+    split_transactions_init();
+    soft_serial_target_init(sstd_table, SPLIT_TRANSACTION_COUNT);
+}
+
+/** \brief Runs the due transactions, in id order
+ *
+ * Returns false, and stops, as soon as one of them fails.
+ */
+bool split_transactions_master(void) {
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    split_link_master_task();
+#    endif
+    bool keyframe = keyframe_due || timer_elapsed(keyframe_time) >= SPLIT_TRANSPORT_KEYFRAME_INTERVAL;
+
+    for (uint8_t id = 0; id < SPLIT_TRANSACTION_COUNT; id++) {
+        const split_transaction_t *transaction = registry[id];
+        if (!transaction) continue;
+
+        if (transaction->master_prepare && transaction->master_prepare()) {
+            pending |= ID_BIT(id);
+        }
+        if (!keyframe) {
+            if (!(pending & ID_BIT(id))) continue;
+            if (timer_elapsed(last_run[id]) < transaction->interval) continue;
+        }
+
+        int result = soft_serial_transaction(id);
+#    ifdef SPLIT_LINK_STATS
+        split_link_record(id, result);
+#    endif
+        if (result != TRANSACTION_END) {
+            keyframe_due = true;
+            return false;
+        }
+        pending &= ~ID_BIT(id);
+        last_run[id] = timer_read();
+        if (transaction->master_received) transaction->master_received();
+    }
+
+    if (keyframe) {
+        keyframe_due  = false;
+        keyframe_time = timer_read();
+    }
+    return true;
+}
+
+/** \brief Refreshes the slave payloads and handles the master payloads that arrived
+ */
+void split_transactions_slave(void) {
+    bool accepted = false;
+
+    for (uint8_t id = 0; id < SPLIT_TRANSACTION_COUNT; id++) {
+        const split_transaction_t *transaction = registry[id];
+        if (!transaction) continue;
+
+        if (transaction->slave_prepare) transaction->slave_prepare();
+        if (status[id] == TRANSACTION_ACCEPTED) {
+            status[id] = TRANSACTION_END;
+            accepted   = true;
+            if (transaction->slave_received) transaction->slave_received();
+        }
+    }
+
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    split_link_slave_task(accepted);
+#    else
+    (void)accepted;
+#    endif
+}
+
+#endif
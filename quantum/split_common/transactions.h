@@ -0,0 +1,103 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Split transaction registry, used by the serial transport with SPLIT_TRANSPORT_DELTA.
+ *
+ * Every piece of state shared between the halves is a transaction with its
+ * own payloads and minimum interval. The master runs a transaction when its
+ * master_prepare() reports a change, or when it was requested, but never more
+ * often than its interval. Everything runs again on each keyframe, every
+ * SPLIT_TRANSPORT_KEYFRAME_INTERVAL milliseconds and after any error.
+ *
+ * Both halves must register the same transactions under the same ids.
+ */
+
+typedef struct {
+    uint8_t  initiator2target_buffer_size;  // master to slave payload
+    void *   initiator2target_buffer;
+    uint8_t  target2initiator_buffer_size;  // slave to master payload
+    void *   target2initiator_buffer;
+    uint16_t interval;                      // minimum milliseconds between two runs
+    bool (*master_prepare)(void);           // fills the master payload, returns true to send it
+    void (*master_received)(void);          // on the master, after the transaction went through
+    void (*slave_prepare)(void);            // on the slave, fills the slave payload on every scan
+    void (*slave_received)(void);           // on the slave, after a master payload arrived
+} split_transaction_t;
+
+enum split_transaction_id {
+    SPLIT_TRANSACTION_ID_SLAVE_VERSION = 0,
+    SPLIT_TRANSACTION_ID_SLAVE_MATRIX,
+#if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    SPLIT_TRANSACTION_ID_RGBLIGHT,
+#endif
+#ifndef DISABLE_SYNC_TIMER
+    SPLIT_TRANSACTION_ID_SYNC_TIMER,
+#endif
+#ifdef SPLIT_TRANSPORT_MIRROR
+    SPLIT_TRANSACTION_ID_MASTER_MATRIX,
+#endif
+#ifdef SPLIT_MODS_ENABLE
+    SPLIT_TRANSACTION_ID_MODS,
+#endif
+#ifdef BACKLIGHT_ENABLE
+    SPLIT_TRANSACTION_ID_BACKLIGHT,
+#endif
+#ifdef WPM_ENABLE
+    SPLIT_TRANSACTION_ID_WPM,
+#endif
+#if defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
+    SPLIT_TRANSACTION_ID_LED_MATRIX,
+#endif
+#if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+    SPLIT_TRANSACTION_ID_RGB_MATRIX,
+#endif
+#ifdef SPLIT_KEY_EVENTS
+    SPLIT_TRANSACTION_ID_KEY_EVENTS_ACK,
+#endif
+#ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    SPLIT_TRANSACTION_ID_SERIAL_SPEED,
+#endif
+    SPLIT_TRANSACTION_ID_USER,  // first id free for keyboard and user transactions
+};
+
+#ifndef SPLIT_TRANSACTION_USER_COUNT
+#    define SPLIT_TRANSACTION_USER_COUNT 4
+#endif
+
+#define SPLIT_TRANSACTION_COUNT (SPLIT_TRANSACTION_ID_USER + SPLIT_TRANSACTION_USER_COUNT)
+
+// Interval of state that is only shown, not acted on: 10 times a second
+#ifndef SPLIT_TRANSACTION_STATE_INTERVAL
+#    define SPLIT_TRANSACTION_STATE_INTERVAL 100
+#endif
+
+// How often everything is sent again, whether it changed or not
+#ifndef SPLIT_TRANSPORT_KEYFRAME_INTERVAL
+#    define SPLIT_TRANSPORT_KEYFRAME_INTERVAL 500
+#endif
+
+void split_transaction_register(uint8_t id, const split_transaction_t *transaction);
+void split_transaction_request(uint8_t id);
+
+void split_transactions_master_init(void);
+void split_transactions_slave_init(void);
+bool split_transactions_master(void);
+void split_transactions_slave(void);
@@ -28,20 +28,23 @@ static pin_t encoders_pad[] = ENCODERS_PAD_A;
 #if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
 #    include "rgb_matrix.h"
 #endif
+#ifdef SPLIT_KEY_EVENTS
+#    include "split_key_events.h"
+#endif
 
 #if defined(USE_I2C)
 
 #    include "i2c_master.h"
 #    include "i2c_slave.h"
 
-typedef struct _I2C_slave_buffer_t {
+// Written by the master, most often changing first
+typedef struct _I2C_m2s_t {
 #    ifndef DISABLE_SYNC_TIMER
     uint32_t sync_timer;
 #    endif
 #    ifdef SPLIT_TRANSPORT_MIRROR
     matrix_row_t mmatrix[ROWS_PER_HAND];
 #    endif
-    matrix_row_t smatrix[ROWS_PER_HAND];
 #    ifdef SPLIT_MODS_ENABLE
     uint8_t real_mods;
     uint8_t weak_mods;
@@ -49,18 +52,15 @@ typedef struct _I2C_slave_buffer_t {
     uint8_t oneshot_mods;
 #        endif
 #    endif
+#    ifdef WPM_ENABLE
+    uint8_t current_wpm;
+#    endif
 #    ifdef BACKLIGHT_ENABLE
     uint8_t backlight_level;
 #    endif
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
     rgblight_syncinfo_t rgblight_sync;
 #    endif
-#    ifdef ENCODER_ENABLE
-    uint8_t encoder_state[NUMBER_OF_ENCODERS];
-#    endif
-#    ifdef WPM_ENABLE
-    uint8_t current_wpm;
-#    endif
 #    if defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
     led_eeconfig_t led_matrix;
     bool           led_suspend_state;
@@ -69,24 +69,25 @@ typedef struct _I2C_slave_buffer_t {
     rgb_config_t rgb_matrix;
     bool         rgb_suspend_state;
 #    endif
+} I2C_m2s_t;
+
+// Read by the master
+typedef struct _I2C_s2m_t {
+    matrix_row_t smatrix[ROWS_PER_HAND];
+#    ifdef ENCODER_ENABLE
+    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+#    endif
+} I2C_s2m_t;
+
+typedef struct _I2C_slave_buffer_t {
+    I2C_s2m_t s2m;
+    I2C_m2s_t m2s;
 } I2C_slave_buffer_t;
 
 static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_reg;
 
-#    define I2C_SYNC_TIME_START offsetof(I2C_slave_buffer_t, sync_timer)
-#    define I2C_KEYMAP_MASTER_START offsetof(I2C_slave_buffer_t, mmatrix)
-#    define I2C_KEYMAP_SLAVE_START offsetof(I2C_slave_buffer_t, smatrix)
-#    define I2C_REAL_MODS_START offsetof(I2C_slave_buffer_t, real_mods)
-#    define I2C_WEAK_MODS_START offsetof(I2C_slave_buffer_t, weak_mods)
-#    define I2C_ONESHOT_MODS_START offsetof(I2C_slave_buffer_t, oneshot_mods)
-#    define I2C_BACKLIGHT_START offsetof(I2C_slave_buffer_t, backlight_level)
-#    define I2C_RGB_START offsetof(I2C_slave_buffer_t, rgblight_sync)
-#    define I2C_ENCODER_START offsetof(I2C_slave_buffer_t, encoder_state)
-#    define I2C_WPM_START offsetof(I2C_slave_buffer_t, current_wpm)
-#    define I2C_LED_MATRIX_START offsetof(I2C_slave_buffer_t, led_matrix)
-#    define I2C_LED_SUSPEND_START offsetof(I2C_slave_buffer_t, led_suspend_state)
-#    define I2C_RGB_MATRIX_START offsetof(I2C_slave_buffer_t, rgb_matrix)
-#    define I2C_RGB_SUSPEND_START offsetof(I2C_slave_buffer_t, rgb_suspend_state)
+#    define I2C_S2M_START offsetof(I2C_slave_buffer_t, s2m)
+#    define I2C_M2S_START offsetof(I2C_slave_buffer_t, m2s)
 
 #    define TIMEOUT 100
 
@@ -94,136 +95,149 @@ static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_re
 #        define SLAVE_I2C_ADDRESS 0x32
 #    endif
 
+// What the slave last got from the master, invalid until the first write and after any error
+static I2C_m2s_t i2c_m2s_sent;
+static bool      i2c_m2s_valid = false;
+
+/** \brief Writes the bytes of the master state that changed, in one transfer
+ *
+ * Only the range from the first to the last changed byte goes out, which
+ * is why the fields changing most often come first.
+ */
+static bool i2c_write_m2s(const I2C_m2s_t *m2s) {
+    const uint8_t *next  = (const uint8_t *)m2s;
+    const uint8_t *sent  = (const uint8_t *)&i2c_m2s_sent;
+    uint8_t        first = 0;
+    uint8_t        end   = sizeof(I2C_m2s_t);
+
+    if (i2c_m2s_valid) {
+        while (first < end && next[first] == sent[first]) first++;
+        while (end > first && next[end - 1] == sent[end - 1]) end--;
+        if (first == end) return true;
+    }
+
+    if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_M2S_START + first, next + first, end - first, TIMEOUT) < 0) {
+        i2c_m2s_valid = false;
+        return false;
+    }
+    i2c_m2s_sent  = *m2s;
+    i2c_m2s_valid = true;
+    return true;
+}
+
 // Get rows from other half over i2c
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
-    i2c_readReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_SLAVE_START, (void *)slave_matrix, sizeof(i2c_buffer->smatrix), TIMEOUT);
-#    ifdef SPLIT_TRANSPORT_MIRROR
-    i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_MASTER_START, (void *)master_matrix, sizeof(i2c_buffer->mmatrix), TIMEOUT);
+    I2C_s2m_t s2m;
+    if (i2c_readReg(SLAVE_I2C_ADDRESS, I2C_S2M_START, (void *)&s2m, sizeof(s2m), TIMEOUT) < 0) {
+        // the slave may have restarted, send it everything again
+        i2c_m2s_valid = false;
+        return false;
+    }
+    memcpy((void *)slave_matrix, (void *)s2m.smatrix, sizeof(s2m.smatrix));
+
+#    ifdef ENCODER_ENABLE
+    encoder_update_raw(s2m.encoder_state);
 #    endif
 
-    // write backlight info
-#    ifdef BACKLIGHT_ENABLE
-    uint8_t level = is_backlight_enabled() ? get_backlight_level() : 0;
-    if (level != i2c_buffer->backlight_level) {
-        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_BACKLIGHT_START, (void *)&level, sizeof(level), TIMEOUT) >= 0) {
-            i2c_buffer->backlight_level = level;
-        }
-    }
+    I2C_m2s_t m2s = i2c_m2s_sent;
+
+#    ifndef DISABLE_SYNC_TIMER
+    m2s.sync_timer = sync_timer_read32() + SYNC_TIMER_OFFSET;
 #    endif
 
-#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
-    if (rgblight_get_change_flags()) {
-        rgblight_syncinfo_t rgblight_sync;
-        rgblight_get_syncinfo(&rgblight_sync);
-        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_RGB_START, (void *)&rgblight_sync, sizeof(rgblight_sync), TIMEOUT) >= 0) {
-            rgblight_clear_change_flags();
-        }
-    }
+#    ifdef SPLIT_TRANSPORT_MIRROR
+    memcpy((void *)m2s.mmatrix, (void *)master_matrix, sizeof(m2s.mmatrix));
 #    endif
 
-#    ifdef ENCODER_ENABLE
-    i2c_readReg(SLAVE_I2C_ADDRESS, I2C_ENCODER_START, (void *)i2c_buffer->encoder_state, sizeof(i2c_buffer->encoder_state), TIMEOUT);
-    encoder_update_raw(i2c_buffer->encoder_state);
+#    ifdef SPLIT_MODS_ENABLE
+    m2s.real_mods = get_mods();
+    m2s.weak_mods = get_weak_mods();
+#        ifndef NO_ACTION_ONESHOT
+    m2s.oneshot_mods = get_oneshot_mods();
+#        endif
 #    endif
 
 #    ifdef WPM_ENABLE
-    uint8_t current_wpm = get_current_wpm();
-    if (current_wpm != i2c_buffer->current_wpm) {
-        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_WPM_START, (void *)&current_wpm, sizeof(current_wpm), TIMEOUT) >= 0) {
-            i2c_buffer->current_wpm = current_wpm;
-        }
-    }
+    m2s.current_wpm = get_current_wpm();
 #    endif
 
-#    ifdef SPLIT_MODS_ENABLE
-    uint8_t real_mods = get_mods();
-    if (real_mods != i2c_buffer->real_mods) {
-        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_REAL_MODS_START, (void *)&real_mods, sizeof(real_mods), TIMEOUT) >= 0) {
-            i2c_buffer->real_mods = real_mods;
-        }
-    }
-
-    uint8_t weak_mods = get_weak_mods();
-    if (weak_mods != i2c_buffer->weak_mods) {
-        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_WEAK_MODS_START, (void *)&weak_mods, sizeof(weak_mods), TIMEOUT) >= 0) {
-            i2c_buffer->weak_mods = weak_mods;
-        }
-    }
+#    ifdef BACKLIGHT_ENABLE
+    m2s.backlight_level = is_backlight_enabled() ? get_backlight_level() : 0;
+#    endif
 
-#        ifndef NO_ACTION_ONESHOT
-    uint8_t oneshot_mods = get_oneshot_mods();
-    if (oneshot_mods != i2c_buffer->oneshot_mods) {
-        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_ONESHOT_MODS_START, (void *)&oneshot_mods, sizeof(oneshot_mods), TIMEOUT) >= 0) {
-            i2c_buffer->oneshot_mods = oneshot_mods;
-        }
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    bool rgblight_changed = rgblight_get_change_flags();
+    if (rgblight_changed) {
+        rgblight_get_syncinfo(&m2s.rgblight_sync);
+    } else {
+        // the slave clears the flags once applied, so a later write does not apply it again
+        m2s.rgblight_sync.status.change_flags = 0;
     }
-#        endif
 #    endif
 
 #    if defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
-    i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_LED_MATRIX_START, (void *)led_matrix_eeconfig, sizeof(i2c_buffer->led_matrix), TIMEOUT);
-    bool suspend_state = led_matrix_get_suspend_state();
-    i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_LED_SUSPEND_START, (void *)suspend_state, sizeof(i2c_buffer->led_suspend_state), TIMEOUT);
+    m2s.led_matrix        = led_matrix_eeconfig;
+    m2s.led_suspend_state = led_matrix_get_suspend_state();
 #    endif
 #    if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
-    i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_RGB_MATRIX_START, (void *)rgb_matrix_config, sizeof(i2c_buffer->rgb_matrix), TIMEOUT);
-    bool suspend_state = rgb_matrix_get_suspend_state();
-    i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_RGB_SUSPEND_START, (void *)suspend_state, sizeof(i2c_buffer->rgb_suspend_state), TIMEOUT);
+    m2s.rgb_matrix        = rgb_matrix_config;
+    m2s.rgb_suspend_state = rgb_matrix_get_suspend_state();
 #    endif
 
-#    ifndef DISABLE_SYNC_TIMER
-    i2c_buffer->sync_timer = sync_timer_read32() + SYNC_TIMER_OFFSET;
-    i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_SYNC_TIME_START, (void *)&i2c_buffer->sync_timer, sizeof(i2c_buffer->sync_timer), TIMEOUT);
+    if (!i2c_write_m2s(&m2s)) return false;
+
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    if (rgblight_changed) rgblight_clear_change_flags();
 #    endif
     return true;
 }
 
 void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
 #    ifndef DISABLE_SYNC_TIMER
-    sync_timer_update(i2c_buffer->sync_timer);
+    sync_timer_update(i2c_buffer->m2s.sync_timer);
 #    endif
     // Copy matrix to I2C buffer
-    memcpy((void *)i2c_buffer->smatrix, (void *)slave_matrix, sizeof(i2c_buffer->smatrix));
+    memcpy((void *)i2c_buffer->s2m.smatrix, (void *)slave_matrix, sizeof(i2c_buffer->s2m.smatrix));
 #    ifdef SPLIT_TRANSPORT_MIRROR
-    memcpy((void *)master_matrix, (void *)i2c_buffer->mmatrix, sizeof(i2c_buffer->mmatrix));
+    memcpy((void *)master_matrix, (void *)i2c_buffer->m2s.mmatrix, sizeof(i2c_buffer->m2s.mmatrix));
 #    endif
 
 // Read Backlight Info
 #    ifdef BACKLIGHT_ENABLE
-    backlight_set(i2c_buffer->backlight_level);
+    backlight_set(i2c_buffer->m2s.backlight_level);
 #    endif
 
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
     // Update the RGB with the new data
-    if (i2c_buffer->rgblight_sync.status.change_flags != 0) {
-        rgblight_update_sync(&i2c_buffer->rgblight_sync, false);
-        i2c_buffer->rgblight_sync.status.change_flags = 0;
+    if (i2c_buffer->m2s.rgblight_sync.status.change_flags != 0) {
+        rgblight_update_sync(&i2c_buffer->m2s.rgblight_sync, false);
+        i2c_buffer->m2s.rgblight_sync.status.change_flags = 0;
     }
 #    endif
 
 #    ifdef ENCODER_ENABLE
-    encoder_state_raw(i2c_buffer->encoder_state);
+    encoder_state_raw(i2c_buffer->s2m.encoder_state);
 #    endif
 
 #    ifdef WPM_ENABLE
-    set_current_wpm(i2c_buffer->current_wpm);
+    set_current_wpm(i2c_buffer->m2s.current_wpm);
 #    endif
 
 #    ifdef SPLIT_MODS_ENABLE
-    set_mods(i2c_buffer->real_mods);
-    set_weak_mods(i2c_buffer->weak_mods);
+    set_mods(i2c_buffer->m2s.real_mods);
+    set_weak_mods(i2c_buffer->m2s.weak_mods);
 #        ifndef NO_ACTION_ONESHOT
-    set_oneshot_mods(i2c_buffer->oneshot_mods);
+    set_oneshot_mods(i2c_buffer->m2s.oneshot_mods);
 #        endif
 #    endif
 
 #    if defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
-    memcpy((void *)i2c_buffer->led_matrix, (void *)led_matrix_eeconfig, sizeof(i2c_buffer->led_matrix));
-    led_matrix_set_suspend_state(i2c_buffer->led_suspend_state);
+    led_matrix_eeconfig = i2c_buffer->m2s.led_matrix;
+    led_matrix_set_suspend_state(i2c_buffer->m2s.led_suspend_state);
 #    endif
 #    if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
-    memcpy((void *)i2c_buffer->rgb_matrix, (void *)rgb_matrix_config, sizeof(i2c_buffer->rgb_matrix));
-    rgb_matrix_set_suspend_state(i2c_buffer->rgb_suspend_state);
+    rgb_matrix_config = i2c_buffer->m2s.rgb_matrix;
+    rgb_matrix_set_suspend_state(i2c_buffer->m2s.rgb_suspend_state);
 #    endif
 }
 
@@ -231,9 +245,413 @@ void transport_master_init(void) { i2c_init(); }
 
 void transport_slave_init(void) { i2c_slave_init(SLAVE_I2C_ADDRESS); }
 
+#elif defined(SPLIT_TRANSPORT_DELTA)
+
+#    include "serial.h"
+#    include "transactions.h"
+#    include "split_link.h"
+
+// Each piece of shared state is its own transaction, see transactions.h.
+// The slave bumps a version on every matrix or encoder change, so a scan
+// where nothing happened only reads that byte back.
+
+typedef struct _Serial_s2m_buffer_t {
+    matrix_row_t smatrix[ROWS_PER_HAND];
+
+#    ifdef ENCODER_ENABLE
+    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+#    endif
+
+#    ifdef SPLIT_KEY_EVENTS
+    split_key_events_packet_t key_events;
+#    endif
+
+    uint8_t version;  // bumped by the slave on every change above
+} Serial_s2m_buffer_t;
+
+static volatile Serial_s2m_buffer_t serial_s2m_buffer    = {};
+static volatile uint8_t             serial_slave_version = 0;
+
+static bool slave_version_prepare(void) { return true; }  // polled every scan
+
+static void slave_version_received(void) {
+    if (serial_slave_version != serial_s2m_buffer.version) {
+        split_transaction_request(SPLIT_TRANSACTION_ID_SLAVE_MATRIX);
+    }
+}
+
+static const split_transaction_t slave_version_transaction = {
+    .target2initiator_buffer_size = sizeof(serial_slave_version),
+    .target2initiator_buffer      = (void *)&serial_slave_version,
+    .master_prepare               = slave_version_prepare,
+    .master_received              = slave_version_received,
+};
+
+static const split_transaction_t slave_matrix_transaction = {
+    .target2initiator_buffer_size = sizeof(serial_s2m_buffer),
+    .target2initiator_buffer      = (void *)&serial_s2m_buffer,
+};
+
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+static rgblight_syncinfo_t serial_rgblight;
+
+static bool rgblight_prepare(void) {
+    if (!rgblight_get_change_flags()) return false;
+    rgblight_get_syncinfo(&serial_rgblight);
+    return true;
+}
+
+static void rgblight_received(void) { rgblight_clear_change_flags(); }
+
+static void rgblight_slave_received(void) { rgblight_update_sync(&serial_rgblight, false); }
+
+static const split_transaction_t rgblight_transaction = {
+    .initiator2target_buffer_size = sizeof(serial_rgblight),
+    .initiator2target_buffer      = &serial_rgblight,
+    .master_prepare               = rgblight_prepare,
+    .master_received              = rgblight_received,
+    .slave_received               = rgblight_slave_received,
+};
+#    endif
+
+#    ifndef DISABLE_SYNC_TIMER
+static uint32_t serial_sync_timer;
+
+// Both halves count milliseconds, so the offset only needs refreshing with each keyframe
+static bool sync_timer_prepare(void) {
+    serial_sync_timer = sync_timer_read32() + SYNC_TIMER_OFFSET;
+    return false;
+}
+
+static void sync_timer_slave_received(void) { sync_timer_update(serial_sync_timer); }
+
+static const split_transaction_t sync_timer_transaction = {
+    .initiator2target_buffer_size = sizeof(serial_sync_timer),
+    .initiator2target_buffer      = &serial_sync_timer,
+    .master_prepare               = sync_timer_prepare,
+    .slave_received               = sync_timer_slave_received,
+};
+#    endif
+
+#    ifdef SPLIT_TRANSPORT_MIRROR
+// Filled by transport_master()
+static matrix_row_t serial_mmatrix[ROWS_PER_HAND];
+
+static const split_transaction_t master_matrix_transaction = {
+    .initiator2target_buffer_size = sizeof(serial_mmatrix),
+    .initiator2target_buffer      = serial_mmatrix,
+};
+#    endif
+
+#    ifdef SPLIT_MODS_ENABLE
+typedef struct _Serial_mods_t {
+    uint8_t real_mods;
+    uint8_t weak_mods;
+#        ifndef NO_ACTION_ONESHOT
+    uint8_t oneshot_mods;
+#        endif
+} Serial_mods_t;
+
+static Serial_mods_t serial_mods;
+
+static bool mods_prepare(void) {
+    Serial_mods_t mods = {
+        .real_mods = get_mods(),
+        .weak_mods = get_weak_mods(),
+#        ifndef NO_ACTION_ONESHOT
+        .oneshot_mods = get_oneshot_mods(),
+#        endif
+    };
+    if (memcmp(&mods, &serial_mods, sizeof(mods)) == 0) return false;
+    serial_mods = mods;
+    return true;
+}
+
+static void mods_slave_received(void) {
+    set_mods(serial_mods.real_mods);
+    set_weak_mods(serial_mods.weak_mods);
+#        ifndef NO_ACTION_ONESHOT
+    set_oneshot_mods(serial_mods.oneshot_mods);
+#        endif
+}
+
+static const split_transaction_t mods_transaction = {
+    .initiator2target_buffer_size = sizeof(serial_mods),
+    .initiator2target_buffer      = &serial_mods,
+    .interval                     = SPLIT_TRANSACTION_STATE_INTERVAL,
+    .master_prepare               = mods_prepare,
+    .slave_received               = mods_slave_received,
+};
+#    endif
+
+#    ifdef BACKLIGHT_ENABLE
+static uint8_t serial_backlight_level;
+
+static bool backlight_prepare(void) {
+    uint8_t level = is_backlight_enabled() ? get_backlight_level() : 0;
+    if (level == serial_backlight_level) return false;
+    serial_backlight_level = level;
+    return true;
+}
+
+static void backlight_slave_received(void) { backlight_set(serial_backlight_level); }
+
+static const split_transaction_t backlight_transaction = {
+    .initiator2target_buffer_size = sizeof(serial_backlight_level),
+    .initiator2target_buffer      = &serial_backlight_level,
+    .interval                     = SPLIT_TRANSACTION_STATE_INTERVAL,
+    .master_prepare               = backlight_prepare,
+    .slave_received               = backlight_slave_received,
+};
+#    endif
+
+#    ifdef WPM_ENABLE
+static uint8_t serial_current_wpm;
+
+static bool wpm_prepare(void) {
+    uint8_t current_wpm = get_current_wpm();
+    if (current_wpm == serial_current_wpm) return false;
+    serial_current_wpm = current_wpm;
+    return true;
+}
+
+static void wpm_slave_received(void) { set_current_wpm(serial_current_wpm); }
+
+static const split_transaction_t wpm_transaction = {
+    .initiator2target_buffer_size = sizeof(serial_current_wpm),
+    .initiator2target_buffer      = &serial_current_wpm,
+    .interval                     = SPLIT_TRANSACTION_STATE_INTERVAL,
+    .master_prepare               = wpm_prepare,
+    .slave_received               = wpm_slave_received,
+};
+#    endif
+
+#    if defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
+typedef struct _Serial_led_matrix_t {
+    led_eeconfig_t led_matrix;
+    bool           led_suspend_state;
+} Serial_led_matrix_t;
+
+static Serial_led_matrix_t serial_led_matrix;
+
+static bool led_matrix_prepare(void) {
+    Serial_led_matrix_t state = {.led_matrix = led_matrix_eeconfig, .led_suspend_state = led_matrix_get_suspend_state()};
+    if (memcmp(&state, &serial_led_matrix, sizeof(state)) == 0) return false;
+    serial_led_matrix = state;
+    return true;
+}
+
+static void led_matrix_slave_received(void) {
+    led_matrix_eeconfig = serial_led_matrix.led_matrix;
+    led_matrix_set_suspend_state(serial_led_matrix.led_suspend_state);
+}
+
+static const split_transaction_t led_matrix_transaction = {
+    .initiator2target_buffer_size = sizeof(serial_led_matrix),
+    .initiator2target_buffer      = &serial_led_matrix,
+    .interval                     = SPLIT_TRANSACTION_STATE_INTERVAL,
+    .master_prepare               = led_matrix_prepare,
+    .slave_received               = led_matrix_slave_received,
+};
+#    endif
+
+#    if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+typedef struct _Serial_rgb_matrix_t {
+    rgb_config_t rgb_matrix;
+    bool         rgb_suspend_state;
+} Serial_rgb_matrix_t;
+
+static Serial_rgb_matrix_t serial_rgb_matrix;
+
+static bool rgb_matrix_prepare(void) {
+    Serial_rgb_matrix_t state = {.rgb_matrix = rgb_matrix_config, .rgb_suspend_state = rgb_matrix_get_suspend_state()};
+    if (memcmp(&state, &serial_rgb_matrix, sizeof(state)) == 0) return false;
+    serial_rgb_matrix = state;
+    return true;
+}
+
+static void rgb_matrix_slave_received(void) {
+    rgb_matrix_config = serial_rgb_matrix.rgb_matrix;
+    rgb_matrix_set_suspend_state(serial_rgb_matrix.rgb_suspend_state);
+}
+
+static const split_transaction_t rgb_matrix_transaction = {
+    .initiator2target_buffer_size = sizeof(serial_rgb_matrix),
+    .initiator2target_buffer      = &serial_rgb_matrix,
+    .interval                     = SPLIT_TRANSACTION_STATE_INTERVAL,
+    .master_prepare               = rgb_matrix_prepare,
+    .slave_received               = rgb_matrix_slave_received,
+};
+#    endif
+
+#    ifdef SPLIT_KEY_EVENTS
+static uint8_t serial_key_events_ack;
+
+static bool key_events_ack_prepare(void) {
+    uint8_t next_seq = split_key_events_next_seq();
+    if (next_seq == serial_key_events_ack) return false;
+    serial_key_events_ack = next_seq;
+    return true;
+}
+
+static void key_events_ack_slave_received(void) { split_key_events_ack(serial_key_events_ack); }
+
+static const split_transaction_t key_events_ack_transaction = {
+    .initiator2target_buffer_size = sizeof(serial_key_events_ack),
+    .initiator2target_buffer      = &serial_key_events_ack,
+    .master_prepare               = key_events_ack_prepare,
+    .slave_received               = key_events_ack_slave_received,
+};
+#    endif
+
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+static uint8_t serial_speed;
+
+static bool serial_speed_prepare(void) {
+    serial_speed = split_link_requested_speed();
+    return serial_speed != soft_serial_get_speed();
+}
+
+static void serial_speed_received(void) { split_link_speed_sent(serial_speed); }
+
+static void serial_speed_slave_received(void) { split_link_slave_received(serial_speed); }
+
+static const split_transaction_t serial_speed_transaction = {
+    .initiator2target_buffer_size = sizeof(serial_speed),
+    .initiator2target_buffer      = &serial_speed,
+    .master_prepare               = serial_speed_prepare,
+    .master_received              = serial_speed_received,
+    .slave_received               = serial_speed_slave_received,
+};
+#    endif
+
+#    ifdef SERIAL_USART_PIPELINE
+// Pipelined frames have a fixed size; the payloads not checked here are a few bytes
+_Static_assert(sizeof(serial_s2m_buffer) <= SERIAL_USART_PIPELINE_BUFFER_SIZE, "slave matrix larger than SERIAL_USART_PIPELINE_BUFFER_SIZE");
+#        if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+_Static_assert(sizeof(serial_rgblight) <= SERIAL_USART_PIPELINE_BUFFER_SIZE, "rgblight sync larger than SERIAL_USART_PIPELINE_BUFFER_SIZE");
+#        endif
+#        ifdef SPLIT_TRANSPORT_MIRROR
+_Static_assert(sizeof(serial_mmatrix) <= SERIAL_USART_PIPELINE_BUFFER_SIZE, "master matrix larger than SERIAL_USART_PIPELINE_BUFFER_SIZE");
+#        endif
+#        if defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
+_Static_assert(sizeof(serial_led_matrix) <= SERIAL_USART_PIPELINE_BUFFER_SIZE, "led matrix state larger than SERIAL_USART_PIPELINE_BUFFER_SIZE");
+#        endif
+#        if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+_Static_assert(sizeof(serial_rgb_matrix) <= SERIAL_USART_PIPELINE_BUFFER_SIZE, "rgb matrix state larger than SERIAL_USART_PIPELINE_BUFFER_SIZE");
+#        endif
+#    endif
+
+static void transport_register(void) {
+    split_transaction_register(SPLIT_TRANSACTION_ID_SLAVE_VERSION, &slave_version_transaction);
+    split_transaction_register(SPLIT_TRANSACTION_ID_SLAVE_MATRIX, &slave_matrix_transaction);
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    split_transaction_register(SPLIT_TRANSACTION_ID_RGBLIGHT, &rgblight_transaction);
+#    endif
+#    ifndef DISABLE_SYNC_TIMER
+    split_transaction_register(SPLIT_TRANSACTION_ID_SYNC_TIMER, &sync_timer_transaction);
+#    endif
+#    ifdef SPLIT_TRANSPORT_MIRROR
+    split_transaction_register(SPLIT_TRANSACTION_ID_MASTER_MATRIX, &master_matrix_transaction);
+#    endif
+#    ifdef SPLIT_MODS_ENABLE
+    split_transaction_register(SPLIT_TRANSACTION_ID_MODS, &mods_transaction);
+#    endif
+#    ifdef BACKLIGHT_ENABLE
+    split_transaction_register(SPLIT_TRANSACTION_ID_BACKLIGHT, &backlight_transaction);
+#    endif
+#    ifdef WPM_ENABLE
+    split_transaction_register(SPLIT_TRANSACTION_ID_WPM, &wpm_transaction);
+#    endif
+#    if defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
+    split_transaction_register(SPLIT_TRANSACTION_ID_LED_MATRIX, &led_matrix_transaction);
+#    endif
+#    if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+    split_transaction_register(SPLIT_TRANSACTION_ID_RGB_MATRIX, &rgb_matrix_transaction);
+#    endif
+#    ifdef SPLIT_KEY_EVENTS
+    split_transaction_register(SPLIT_TRANSACTION_ID_KEY_EVENTS_ACK, &key_events_ack_transaction);
+#    endif
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    split_transaction_register(SPLIT_TRANSACTION_ID_SERIAL_SPEED, &serial_speed_transaction);
+#    endif
+}
+
+void transport_master_init(void) {
+    transport_register();
+    split_transactions_master_init();
+}
+
+void transport_slave_init(void) {
+    transport_register();
+    split_transactions_slave_init();
+}
+
+bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+#    ifdef SPLIT_TRANSPORT_MIRROR
+    if (memcmp(serial_mmatrix, master_matrix, sizeof(serial_mmatrix)) != 0) {
+        memcpy(serial_mmatrix, master_matrix, sizeof(serial_mmatrix));
+        split_transaction_request(SPLIT_TRANSACTION_ID_MASTER_MATRIX);
+    }
+#    endif
+
+    if (!split_transactions_master()) {
+        return false;
+    }
+
+#    ifdef SPLIT_KEY_EVENTS
+    split_key_events_apply((const split_key_events_packet_t *)&serial_s2m_buffer.key_events, (const matrix_row_t *)serial_s2m_buffer.smatrix, slave_matrix);
+#    else
+    for (int i = 0; i < ROWS_PER_HAND; ++i) {
+        slave_matrix[i] = serial_s2m_buffer.smatrix[i];
+    }
+#    endif
+
+#    ifdef ENCODER_ENABLE
+    encoder_update_raw((uint8_t *)serial_s2m_buffer.encoder_state);
+#    endif
+    return true;
+}
+
+void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    bool changed = false;
+
+    for (int i = 0; i < ROWS_PER_HAND; ++i) {
+        if (serial_s2m_buffer.smatrix[i] != slave_matrix[i]) {
+            serial_s2m_buffer.smatrix[i] = slave_matrix[i];
+            changed                      = true;
+        }
+#    ifdef SPLIT_TRANSPORT_MIRROR
+        master_matrix[i] = serial_mmatrix[i];
+#    endif
+    }
+
+#    ifdef ENCODER_ENABLE
+    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+    encoder_state_raw(encoder_state);
+    if (memcmp((const void *)serial_s2m_buffer.encoder_state, encoder_state, sizeof(encoder_state)) != 0) {
+        memcpy((void *)serial_s2m_buffer.encoder_state, encoder_state, sizeof(encoder_state));
+        changed = true;
+    }
+#    endif
+
+#    ifdef SPLIT_KEY_EVENTS
+    changed |= split_key_events_fill((split_key_events_packet_t *)&serial_s2m_buffer.key_events);
+#    endif
+
+    // The version goes last, so a master seeing it also gets the data
+    if (changed) {
+        serial_s2m_buffer.version++;
+        serial_slave_version = serial_s2m_buffer.version;
+    }
+
+    split_transactions_slave();
+}
+
 #else  // USE_SERIAL
 
 #    include "serial.h"
+#    include "split_link.h"
 
 typedef struct _Serial_s2m_buffer_t {
     // TODO: if MATRIX_COLS > 8 change to uint8_t packed_matrix[] for pack/unpack
@@ -243,6 +661,10 @@ typedef struct _Serial_s2m_buffer_t {
     uint8_t encoder_state[NUMBER_OF_ENCODERS];
 #    endif
 
+#    ifdef SPLIT_KEY_EVENTS
+    split_key_events_packet_t key_events;
+#    endif
+
 } Serial_s2m_buffer_t;
 
 typedef struct _Serial_m2s_buffer_t {
@@ -273,6 +695,12 @@ typedef struct _Serial_m2s_buffer_t {
     rgb_config_t rgb_matrix;
     bool         rgb_suspend_state;
 #    endif
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    uint8_t serial_speed;
+#    endif
+#    ifdef SPLIT_KEY_EVENTS
+    uint8_t key_events_ack;
+#    endif
 } Serial_m2s_buffer_t;
 
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
@@ -320,6 +748,15 @@ SSTD_t transactions[] = {
 #    endif
 };
 
+#    ifdef SERIAL_USART_PIPELINE
+// Pipelined frames have a fixed size
+_Static_assert(sizeof(serial_m2s_buffer) <= SERIAL_USART_PIPELINE_BUFFER_SIZE, "serial_m2s_buffer larger than SERIAL_USART_PIPELINE_BUFFER_SIZE");
+_Static_assert(sizeof(serial_s2m_buffer) <= SERIAL_USART_PIPELINE_BUFFER_SIZE, "serial_s2m_buffer larger than SERIAL_USART_PIPELINE_BUFFER_SIZE");
+#        if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+_Static_assert(sizeof(serial_rgblight) <= SERIAL_USART_PIPELINE_BUFFER_SIZE, "serial_rgblight larger than SERIAL_USART_PIPELINE_BUFFER_SIZE");
+#        endif
+#    endif
+
 void transport_master_init(void) { soft_serial_initiator_init(transactions, TID_LIMIT(transactions)); }
 
 void transport_slave_init(void) { soft_serial_target_init(transactions, TID_LIMIT(transactions)); }
@@ -331,7 +768,11 @@ void transport_slave_init(void) { soft_serial_target_init(transactions, TID_LIMI
 void transport_rgblight_master(void) {
     if (rgblight_get_change_flags()) {
         rgblight_get_syncinfo((rgblight_syncinfo_t *)&serial_rgblight.rgblight_sync);
-        if (soft_serial_transaction(PUT_RGBLIGHT) == TRANSACTION_END) {
+        int result = soft_serial_transaction(PUT_RGBLIGHT);
+#        ifdef SPLIT_LINK_STATS
+        split_link_record(PUT_RGBLIGHT, result);
+#        endif
+        if (result == TRANSACTION_END) {
             rgblight_clear_change_flags();
         }
     }
@@ -350,20 +791,37 @@ void transport_rgblight_slave(void) {
 #    endif
 
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    split_link_master_task();
+    serial_m2s_buffer.serial_speed = split_link_requested_speed();
+#    endif
+
 #    ifndef SERIAL_USE_MULTI_TRANSACTION
-    if (soft_serial_transaction() != TRANSACTION_END) {
-        return false;
-    }
+    int result = soft_serial_transaction();
 #    else
     transport_rgblight_master();
-    if (soft_serial_transaction(GET_SLAVE_MATRIX) != TRANSACTION_END) {
+    int result = soft_serial_transaction(GET_SLAVE_MATRIX);
+#    endif
+#    ifdef SPLIT_LINK_STATS
+    split_link_record(GET_SLAVE_MATRIX, result);
+#    endif
+    if (result != TRANSACTION_END) {
         return false;
     }
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    split_link_speed_sent(serial_m2s_buffer.serial_speed);
+#    endif
+
+#    ifdef SPLIT_KEY_EVENTS
+    split_key_events_apply((const split_key_events_packet_t *)&serial_s2m_buffer.key_events, (const matrix_row_t *)serial_s2m_buffer.smatrix, slave_matrix);
+    serial_m2s_buffer.key_events_ack = split_key_events_next_seq();
 #    endif
 
     // TODO:  if MATRIX_COLS > 8 change to unpack()
     for (int i = 0; i < ROWS_PER_HAND; ++i) {
+#    ifndef SPLIT_KEY_EVENTS
         slave_matrix[i] = serial_s2m_buffer.smatrix[i];
+#    endif
 #    ifdef SPLIT_TRANSPORT_MIRROR
         serial_m2s_buffer.mmatrix[i] = master_matrix[i];
 #    endif
@@ -412,6 +870,15 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
     sync_timer_update(serial_m2s_buffer.sync_timer);
 #    endif
 
+#    ifdef SOFT_SERIAL_ADAPTIVE_SPEED
+    bool accepted = status0 == TRANSACTION_ACCEPTED;
+    if (accepted) {
+        status0 = TRANSACTION_END;
+        split_link_slave_received(serial_m2s_buffer.serial_speed);
+    }
+    split_link_slave_task(accepted);
+#    endif
+
     // TODO: if MATRIX_COLS > 8 change to pack()
     for (int i = 0; i < ROWS_PER_HAND; ++i) {
         serial_s2m_buffer.smatrix[i] = slave_matrix[i];
@@ -427,6 +894,11 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[])
     encoder_state_raw((uint8_t *)serial_s2m_buffer.encoder_state);
 #    endif
 
+#    ifdef SPLIT_KEY_EVENTS
+    split_key_events_ack(serial_m2s_buffer.key_events_ack);
+    split_key_events_fill((split_key_events_packet_t *)&serial_s2m_buffer.key_events);
+#    endif
+
 #    ifdef WPM_ENABLE
     set_current_wpm(serial_m2s_buffer.current_wpm);
 #    endif
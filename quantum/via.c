@@ -47,6 +47,9 @@
 #include "tmk_core/common/eeprom.h"
 #include "version.h"  // for QMK_BUILDDATE used in EEPROM magic
 #include "via_ensure_keycode.h"
+#include "scan_profile.h"
+#include "latency_trace.h"
+#include "tapping_stats.h"
 
 // Forward declare some helpers.
 #if defined(VIA_QMK_BACKLIGHT_ENABLE)
@@ -246,6 +249,30 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
 #endif
                     break;
                 }
+#ifdef SCAN_PROFILE_ENABLE
+                case id_scan_profile: {
+                    if (!scan_profile_raw_hid_query(&command_data[1], length - 2)) {
+                        *command_id = id_unhandled;
+                    }
+                    break;
+                }
+#endif
+#ifdef LATENCY_TRACE_ENABLE
+                case id_latency_trace: {
+                    if (!latency_trace_raw_hid_query(&command_data[1], length - 2)) {
+                        *command_id = id_unhandled;
+                    }
+                    break;
+                }
+#endif
+#ifdef TAPPING_STATS_ENABLE
+                case id_tapping_stats: {
+                    if (!tapping_stats_raw_hid_query(&command_data[1], length - 2)) {
+                        *command_id = id_unhandled;
+                    }
+                    break;
+                }
+#endif
                 default: {
                     raw_hid_receive_kb(data, length);
                     break;
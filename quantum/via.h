@@ -84,7 +84,11 @@ enum via_command_id {
 enum via_keyboard_value_id {
     id_uptime              = 0x01,  //
     id_layout_options      = 0x02,
-    id_switch_matrix_state = 0x03
+    id_switch_matrix_state = 0x03,
+    // QMK diagnostics, not used by VIA Configurator
+    id_scan_profile        = 0x40,
+    id_latency_trace       = 0x41,
+    id_tapping_stats       = 0x42
 };
 
 enum via_lighting_value {
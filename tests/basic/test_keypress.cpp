@@ -40,23 +40,53 @@ TEST_F(KeyPress, CorrectKeyIsReportedWhenPressed) {
 
 TEST_F(KeyPress, CorrectKeysAreReportedWhenTwoKeysArePressed) {
     TestDriver driver;
+    InSequence s;
     press_key(1, 0);
     press_key(0, 3);
-    // Note that QMK only processes one key at a time
-    // See issue #1476 for more information
+    // Both keys are processed by the same scan, in matrix order
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
-    keyboard_task();
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_C)));
     keyboard_task();
     release_key(1, 0);
     release_key(0, 3);
     // Note that the first key released is the first one in the matrix order
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
-    keyboard_task();
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
     keyboard_task();
 }
 
+TEST_F(KeyPress, ChordIsReportedWithinOneScan) {
+    TestDriver driver;
+    InSequence s;
+    unsigned   scans_until_reported = 0;
+    bool       chord_reported       = false;
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D))).WillOnce(testing::Assign(&chord_reported, true));
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(0, 3);
+    press_key(1, 3);
+    while (!chord_reported && scans_until_reported < 10) {
+        run_one_scan_loop();
+        scans_until_reported++;
+    }
+    EXPECT_EQ(scans_until_reported, 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(0, 3);
+    release_key(1, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_C, KC_D)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C, KC_D)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_D)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
 TEST_F(KeyPress, ANonMappedKeyDoesNothing) {
     TestDriver driver;
     press_key(2, 0);
@@ -67,12 +97,12 @@ TEST_F(KeyPress, ANonMappedKeyDoesNothing) {
 
 TEST_F(KeyPress, LeftShiftIsReportedCorrectly) {
     TestDriver driver;
+    InSequence s;
     press_key(3, 0);
     press_key(0, 0);
     // Unfortunately modifiers are also processed in the wrong order
     // See issue #1476 for more information
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
-    keyboard_task();
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_LSFT)));
     keyboard_task();
     release_key(0, 0);
@@ -85,24 +115,20 @@ TEST_F(KeyPress, LeftShiftIsReportedCorrectly) {
 
 TEST_F(KeyPress, PressLeftShiftAndControl) {
     TestDriver driver;
+    InSequence s;
     press_key(3, 0);
     press_key(5, 0);
-    // Unfortunately modifiers are also processed in the wrong order
-    // See issue #1476 for more information
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
-    keyboard_task();
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_LCTRL)));
     keyboard_task();
 }
 
 TEST_F(KeyPress, LeftAndRightShiftCanBePressedAtTheSameTime) {
     TestDriver driver;
+    InSequence s;
     press_key(3, 0);
     press_key(4, 0);
-    // Unfortunately modifiers are also processed in the wrong order
-    // See issue #1476 for more information
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
-    keyboard_task();
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_RSFT)));
     keyboard_task();
 }
@@ -95,3 +95,24 @@ TEST_F(Tapping, ANewTapWithinTappingTermIsBuggy) {
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).Times(1);
     idle_for(TAPPING_TERM);
 }
+
+TEST_F(Tapping, TapKeyAndRegularKeyInTheSameScanAreProcessedInMatrixOrder) {
+    TestDriver driver;
+    InSequence s;
+
+    // KC_A comes before SFT_T(KC_P) in the matrix, so it is processed before the
+    // tap key starts and is reported straight away
+    press_key(0, 0);
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The same order holds for the releases, so the tap key sees no interruption
+    release_key(0, 0);
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
@@ -0,0 +1,45 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {{KC_J, KC_K, KC_L, KC_A, KC_B, SFT_T(KC_S), KC_D, KC_C, MO(1), LT(1, KC_SPC)}},
+    [1] = {{KC_1, _______, _______, _______, _______, _______, _______, KC_2, _______, _______}},
+};
+
+enum combos { JK_ESC, JKL_TAB, AB_Q, SD_X, KL_Z, N12_ESC };
+
+const uint16_t PROGMEM jk_combo[]  = {KC_J, KC_K, COMBO_END};
+const uint16_t PROGMEM jkl_combo[] = {KC_J, KC_K, KC_L, COMBO_END};
+const uint16_t PROGMEM ab_combo[]  = {KC_A, KC_B, COMBO_END};
+const uint16_t PROGMEM sd_combo[]  = {SFT_T(KC_S), KC_D, COMBO_END};
+const uint16_t PROGMEM kl_combo[]  = {KC_K, KC_L, COMBO_END};
+const uint16_t PROGMEM n12_combo[] = {KC_1, KC_2, COMBO_END};
+
+combo_t key_combos[COMBO_COUNT] = {
+    [JK_ESC]  = COMBO(jk_combo, KC_ESC),
+    [JKL_TAB] = COMBO(jkl_combo, KC_TAB),
+    [AB_Q]    = COMBO(ab_combo, KC_Q),
+    [SD_X]    = COMBO(sd_combo, KC_X),
+    [KL_Z]    = COMBO(kl_combo, KC_Z),
+    [N12_ESC] = COMBO(n12_combo, KC_ESC),
+};
+
+uint16_t get_combo_term(uint16_t combo_index, combo_t *combo) { return combo_index == AB_Q ? 20 : COMBO_TERM; }
+
+// K+L only on layer 1
+bool combo_should_trigger(uint16_t combo_index, combo_t *combo, uint16_t keycode, keyrecord_t *record) { return combo_index != KL_Z || layer_state_is(1); }
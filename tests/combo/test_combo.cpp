@@ -0,0 +1,307 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+// Columns of the test keymap, all on row 0
+enum { J, K, L, A, B, SFT_S, D, C, MO_1, LT_1 };
+
+class Combo : public TestFixture {};
+
+TEST_F(Combo, FiresWhenAllKeysArePressed) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(A, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    press_key(B, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    run_one_scan_loop();
+
+    // The first key up releases the combo
+    release_key(A, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(B, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, LongestMatchWins) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(J, 0);
+    press_key(K, 0);
+    press_key(L, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_TAB)));
+    run_one_scan_loop();
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, ShorterComboWaitsForTheLongerOne) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(J, 0);
+    press_key(K, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(COMBO_TERM - 1);
+    // J+K+L can no longer complete
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    run_one_scan_loop();
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, ShorterComboFiresWhenAnotherKeyFollows) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(J, 0);
+    press_key(K, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    press_key(C, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC, KC_C)));
+    run_one_scan_loop();
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, KeysMustBePressedBackToBack) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(J, 0);
+    run_one_scan_loop();
+    press_key(C, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_J)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_J, KC_C)));
+    run_one_scan_loop();
+
+    // K starts over, and is a key of its own once its combos time out
+    press_key(K, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(COMBO_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_J, KC_C, KC_K)));
+    run_one_scan_loop();
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(3);
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, ReleaseBeforeTheComboCompletes) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(J, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    release_key(J, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_J)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, ReleaseOfAnotherKeyWaitsForTheBufferedOnes) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(C, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    run_one_scan_loop();
+    press_key(J, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+
+    // C must not go up before J, which went down while C was held
+    release_key(C, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C, KC_J)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_J)));
+    run_one_scan_loop();
+    release_key(J, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, PerComboTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    // A+B only waits 20 ms
+    press_key(A, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(19);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    press_key(B, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(19);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    run_one_scan_loop();
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, LayerScopedCombo) {
+    TestDriver driver;
+    InSequence s;
+
+    // Not on layer 0
+    press_key(K, 0);
+    press_key(L, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(COMBO_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_K)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_K, KC_L)));
+    run_one_scan_loop();
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    run_one_scan_loop();
+
+    // layer keys send an empty report
+    press_key(MO_1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    press_key(K, 0);
+    press_key(L, 0);
+    // J+K+L could still complete
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(COMBO_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    run_one_scan_loop();
+    clear_all_keys();
+    // one for the combo, one for the layer key
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(2);
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, LayerScopedComboUnderAHeldLayerTap) {
+    TestDriver driver;
+    InSequence s;
+
+    // K and L wait for the layer tap key to be decided
+    press_key(LT_1, 0);
+    run_one_scan_loop();
+    press_key(K, 0);
+    run_one_scan_loop();
+    press_key(L, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 3);
+    // held: layer 1 is on, K+L is a combo there
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    idle_for(2);
+    release_key(K, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(L, 0);
+    run_one_scan_loop();
+    release_key(LT_1, 0);
+    // the layer key
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, ComboOfRemappedKeysUnderAHeldLayerTap) {
+    TestDriver driver;
+    InSequence s;
+
+    // J and C are 1 and 2 on layer 1
+    press_key(LT_1, 0);
+    run_one_scan_loop();
+    press_key(J, 0);
+    run_one_scan_loop();
+    press_key(C, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    idle_for(2);
+    // J goes up as the 1 it was pressed as
+    release_key(J, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(C, 0);
+    run_one_scan_loop();
+    release_key(LT_1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, KeysUnderATappedLayerTapUseTheBaseLayer) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(LT_1, 0);
+    run_one_scan_loop();
+    press_key(K, 0);
+    run_one_scan_loop();
+    press_key(L, 0);
+    run_one_scan_loop();
+    // tapped: K+L is no combo on layer 0
+    release_key(LT_1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_SPC)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_K)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_K, KC_L)));
+    idle_for(COMBO_TERM);
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, BufferedKeyKeepsItsPressTime) {
+    TestDriver driver;
+    InSequence s;
+
+    // Held back for the combo term, then handed to the tap-hold logic
+    // as pressed back then: it is still a hold after TAPPING_TERM.
+    press_key(SFT_S, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(SFT_S, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, TapHoldKeyInACombo) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(SFT_S, 0);
+    run_one_scan_loop();
+    press_key(D, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X)));
+    run_one_scan_loop();
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
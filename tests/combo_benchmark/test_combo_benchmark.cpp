@@ -0,0 +1,124 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+extern "C" {
+#include "process_combo.h"
+
+extern combo_t key_combos[];
+extern int     COMBO_LEN;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+/* Measures the CPU time process_combo() takes per key event, on the host,
+ * for chording layouts of 10, 100 and 500 combos. The absolute numbers
+ * don't carry over to a microcontroller, the ratios mostly do.
+ */
+
+// Combos of two or three of these keys, like a steno layout
+#define COMBO_BENCHMARK_KEYS 36
+#define COMBO_BENCHMARK_CHORDS 2000
+
+static uint16_t combo_keys[COMBO_BENCHMARK_MAX][4];
+static unsigned combos_fired;
+
+extern "C" void process_combo_event(uint16_t combo_index, bool pressed) {
+    if (pressed) combos_fired++;
+}
+
+class ComboBenchmark : public TestFixture {
+   protected:
+    // Deterministic, so every run sees the same combos and chords
+    uint32_t next_random() {
+        random_ = random_ * 1103515245 + 12345;
+        return random_ >> 16;
+    }
+
+    uint16_t random_key() { return KC_A + next_random() % COMBO_BENCHMARK_KEYS; }
+
+    void make_combos(int count) {
+        for (int i = 0; i < count; i++) {
+            uint8_t length = 2 + next_random() % 2;
+            for (uint8_t k = 0; k < length; k++) {
+                uint16_t key;
+                do {
+                    key = random_key();
+                } while (std::find(combo_keys[i], combo_keys[i] + k, key) != combo_keys[i] + k);
+                combo_keys[i][k] = key;
+            }
+            combo_keys[i][length] = COMBO_END;
+            key_combos[i]         = (combo_t)COMBO_ACTION(combo_keys[i]);
+        }
+        COMBO_LEN = count;
+    }
+
+    void event(uint16_t keycode, bool pressed) {
+        keyrecord_t record = {.event = {.key = {.col = 0, .row = 0}, .pressed = pressed, .time = (uint16_t)(timer_read() | 1)}};
+        process_combo(keycode, &record);
+    }
+
+    // Presses the keys of random combos, then random keys on their own
+    void run(int count) {
+        TestDriver driver;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+        make_combos(count);
+        combos_fired = 0;
+
+        unsigned events = 0;
+        auto     start  = std::chrono::steady_clock::now();
+        for (int chord = 0; chord < COMBO_BENCHMARK_CHORDS; chord++) {
+            const uint16_t *keys = combo_keys[next_random() % count];
+            for (const uint16_t *key = keys; *key != COMBO_END; key++, events++) event(*key, true);
+            for (const uint16_t *key = keys; *key != COMBO_END; key++, events++) event(*key, false);
+        }
+        auto chords_end = std::chrono::steady_clock::now();
+        for (int stroke = 0; stroke < COMBO_BENCHMARK_CHORDS; stroke++, events += 2) {
+            // a key outside of every combo
+            event(KC_SPACE, true);
+            event(KC_SPACE, false);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        report(count, "chord", chords_end - start, events - 2 * COMBO_BENCHMARK_CHORDS);
+        report(count, "other key", end - chords_end, 2 * COMBO_BENCHMARK_CHORDS);
+        // Every chord completes its combo, or a shorter one inside it
+        EXPECT_GE(combos_fired, (unsigned)COMBO_BENCHMARK_CHORDS);
+
+        clear_keyboard();
+        COMBO_LEN = 0;
+    }
+
+    void report(int count, const char *name, std::chrono::nanoseconds elapsed, unsigned events) {
+        double ns_per_event = static_cast<double>(elapsed.count()) / events;
+        std::cout << count << " combos: " << ns_per_event << " ns per " << name << " event" << std::endl;
+    }
+
+    uint32_t random_ = 1;
+};
+
+TEST_F(ComboBenchmark, TenCombos) { run(10); }
+
+TEST_F(ComboBenchmark, HundredCombos) { run(100); }
+
+TEST_F(ComboBenchmark, FiveHundredCombos) { run(500); }
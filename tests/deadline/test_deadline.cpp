@@ -0,0 +1,130 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "deadline.h"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+// Columns of the test keymap, all on row 0
+enum { SFT_ESC, TD_ENT_TAB, OSM_SFT, SPACE, A };
+
+class Deadline : public TestFixture {};
+
+TEST_F(Deadline, NothingIsArmedWhileIdle) {
+    TestDriver driver;
+
+    idle_for(10);
+    for (uint8_t id = 0; id < DEADLINE_COUNT; id++) {
+        EXPECT_FALSE(deadline_armed((deadline_id_t)id)) << "deadline " << (int)id;
+    }
+}
+
+TEST_F(Deadline, TapHoldResolvesAtTheEndOfTheTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(SFT_ESC, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    EXPECT_TRUE(deadline_armed(DEADLINE_TAPPING));
+    idle_for(TAPPING_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    EXPECT_FALSE(deadline_armed(DEADLINE_TAPPING));
+
+    release_key(SFT_ESC, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Deadline, TappedKeyStopsWaitingAtTheEndOfTheTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(SFT_ESC, 0);
+    run_one_scan_loop();
+    release_key(SFT_ESC, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    // Still waiting for a second tap
+    EXPECT_TRUE(deadline_armed(DEADLINE_TAPPING));
+    idle_for(TAPPING_TERM);
+    EXPECT_FALSE(deadline_armed(DEADLINE_TAPPING));
+}
+
+TEST_F(Deadline, TapDanceFinishesAfterTheTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(TD_ENT_TAB, 0);
+    run_one_scan_loop();
+    release_key(TD_ENT_TAB, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    EXPECT_TRUE(deadline_armed(DEADLINE_TAP_DANCE));
+    idle_for(TAPPING_TERM - 1);
+    // Finishing the dance sends the mods it started with first
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ENT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(2);
+    run_one_scan_loop();
+    EXPECT_FALSE(deadline_armed(DEADLINE_TAP_DANCE));
+}
+
+TEST_F(Deadline, OneShotModTimesOut) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(OSM_SFT, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    release_key(OSM_SFT, 0);
+    run_one_scan_loop();
+    EXPECT_TRUE(deadline_armed(DEADLINE_ONESHOT));
+    idle_for(ONESHOT_TIMEOUT);
+    EXPECT_FALSE(deadline_armed(DEADLINE_ONESHOT));
+
+    press_key(SPACE, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_SPC)));
+    run_one_scan_loop();
+    release_key(SPACE, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Deadline, AutoShiftFiresAtTheTimeout) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(A, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    EXPECT_TRUE(deadline_armed(DEADLINE_AUTO_SHIFT));
+    idle_for(AUTO_SHIFT_TIMEOUT - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    EXPECT_FALSE(deadline_armed(DEADLINE_AUTO_SHIFT));
+
+    release_key(A, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    run_one_scan_loop();
+}
@@ -0,0 +1,116 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "eeprom.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+#define LAYER_SIZE (MATRIX_ROWS * MATRIX_COLS * 2)
+
+class DynamicKeymap : public TestFixture {
+   protected:
+    void SetUp() override {
+        dynamic_keymap_reset();
+        dynamic_keymap_init();
+    }
+
+    // Every keycode, cached or not, matches the big-endian bytes in EEPROM
+    void expect_coherent() {
+        uint8_t buffer[DYNAMIC_KEYMAP_LAYER_COUNT * LAYER_SIZE];
+        dynamic_keymap_get_buffer(0, sizeof(buffer), buffer);
+        for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    uint16_t offset = layer * LAYER_SIZE + (row * MATRIX_COLS + col) * 2;
+                    EXPECT_EQ(dynamic_keymap_get_keycode(layer, row, col), (buffer[offset] << 8) | buffer[offset + 1]) << "layer " << +layer << " row " << +row << " col " << +col;
+                }
+            }
+        }
+    }
+};
+
+TEST_F(DynamicKeymap, ResetCopiesTheKeymapFromFlash) {
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 1), KC_B);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 3, 0), MO(1));
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 1, 1), KC_F12);
+    expect_coherent();
+}
+
+TEST_F(DynamicKeymap, InitLoadsTheCacheFromEeprom) {
+    // Written behind the dynamic keymap's back, as a previous firmware would have left it
+    uint8_t *address = (uint8_t *)dynamic_keymap_key_to_eeprom_address(0, 2, 3);
+    eeprom_update_byte(address, MO(1) >> 8);
+    eeprom_update_byte(address + 1, MO(1) & 0xFF);
+
+    dynamic_keymap_init();
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 2, 3), MO(1));
+    expect_coherent();
+}
+
+TEST_F(DynamicKeymap, SetKeycodeUpdatesBothLayers) {
+    dynamic_keymap_set_keycode(0, 1, 2, LCTL(KC_Z));
+    dynamic_keymap_set_keycode(1, 2, 9, KC_MUTE);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 1, 2), LCTL(KC_Z));
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 2, 9), KC_MUTE);
+    expect_coherent();
+}
+
+TEST_F(DynamicKeymap, SetBufferAtAnOddOffset) {
+    // Low byte of 0,0,0, both bytes of 0,0,1, high byte of 0,0,2
+    uint8_t data[] = {0x11, 0x22, 0x33, 0x44};
+    dynamic_keymap_set_buffer(1, sizeof(data), data);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 0), (KC_A & 0xFF00) | 0x11);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 1), 0x2233);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 2), 0x4400 | (KC_C & 0xFF));
+    expect_coherent();
+}
+
+TEST_F(DynamicKeymap, SetBufferAcrossTheEndOfTheCache) {
+    // The last keycode of layer 0 is cached, the first of layer 1 is not
+    uint8_t data[] = {0x55, 0x66, 0x77, 0x88};
+    dynamic_keymap_set_buffer(LAYER_SIZE - 1, sizeof(data), data);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 3, 9), (KC_BSPC & 0xFF00) | 0x55);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 0, 0), 0x6677);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 0, 1), 0x8800 | (KC_F2 & 0xFF));
+    expect_coherent();
+}
+
+TEST_F(DynamicKeymap, SetBufferPastTheKeymapIsIgnored) {
+    uint8_t data[] = {0x99, 0xAA};
+    dynamic_keymap_set_buffer(DYNAMIC_KEYMAP_LAYER_COUNT * LAYER_SIZE - 1, sizeof(data), data);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 3, 9), (KC_TRNS & 0xFF00) | 0x99);
+    expect_coherent();
+}
+
+TEST_F(DynamicKeymap, KeypressUsesTheNewKeycode) {
+    TestDriver driver;
+    InSequence s;
+
+    dynamic_keymap_set_keycode(0, 0, 0, KC_Q);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
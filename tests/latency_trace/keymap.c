@@ -0,0 +1,37 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+enum custom_keycodes {
+    PLAY_A = SAFE_RANGE,
+};
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {{KC_A, SFT_T(KC_P), KC_NO, KC_1, PLAY_A}},
+};
+
+// Plays back a tap of the A key, the way dynamic macros do
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (keycode == PLAY_A && record->event.pressed) {
+        keyrecord_t macro = {.event = {.key = {.row = 0, .col = 0}, .pressed = true, .time = record->event.time}};
+        process_record(&macro);
+        macro.event.pressed = false;
+        process_record(&macro);
+        return false;
+    }
+    return true;
+}
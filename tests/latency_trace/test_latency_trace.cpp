@@ -0,0 +1,211 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "latency_trace.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class LatencyTrace : public TestFixture {
+   protected:
+    void SetUp() override { latency_trace_clear(); }
+
+    void expect_trace(uint8_t index, uint8_t col, bool pressed, uint16_t latency, uint8_t source = LATENCY_TRACE_DIRECT) {
+        const latency_trace_t *trace = latency_trace_get(index);
+        ASSERT_NE(trace, nullptr);
+        EXPECT_EQ(trace->key.row, 0);
+        EXPECT_EQ(trace->key.col, col);
+        EXPECT_EQ(trace->pressed, pressed);
+        EXPECT_EQ(trace->source, source);
+        // event times are rounded up to an odd millisecond
+        EXPECT_NEAR(trace->latency, latency, 1);
+    }
+};
+
+TEST_F(LatencyTrace, RegularKeyIsReportedInTheSameScan) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    ASSERT_EQ(latency_trace_count(), 2);
+    expect_trace(0, 0, false, 0);
+    expect_trace(1, 0, true, 0);
+}
+
+TEST_F(LatencyTrace, TapIsDelayedUntilRelease) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(50);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    ASSERT_EQ(latency_trace_count(), 2);
+    // The press is only known to be a tap when the key is released
+    expect_trace(1, 1, true, 50, LATENCY_TRACE_TAPPING);
+    expect_trace(0, 1, false, 0);
+}
+
+TEST_F(LatencyTrace, HoldIsDelayedByTheTappingTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    ASSERT_EQ(latency_trace_count(), 2);
+    expect_trace(1, 1, true, TAPPING_TERM, LATENCY_TRACE_TAPPING);
+}
+
+TEST_F(LatencyTrace, EventsWithoutAReportAreNotTraced) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    idle_for(10);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    ASSERT_EQ(latency_trace_count(), 2);
+    expect_trace(1, 0, true, 0);
+    expect_trace(0, 0, false, 0);
+}
+
+TEST_F(LatencyTrace, AutoShiftTimeoutIsCreditedToTheKey) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(3, 0);
+    idle_for(AUTO_SHIFT_TIMEOUT + 10);
+    release_key(3, 0);
+    run_one_scan_loop();
+
+    ASSERT_GE(latency_trace_count(), 1);
+    expect_trace(latency_trace_count() - 1, 3, true, AUTO_SHIFT_TIMEOUT, LATENCY_TRACE_AUTO_SHIFT);
+}
+
+TEST_F(LatencyTrace, AutoShiftEndedByAnotherKeyIsCreditedToTheShiftedKey) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(3, 0);
+    idle_for(20);
+    // a key sending nothing ends the auto shift: the report is not its own
+    press_key(2, 0);
+    run_one_scan_loop();
+
+    ASSERT_EQ(latency_trace_count(), 1);
+    expect_trace(0, 3, true, 20, LATENCY_TRACE_AUTO_SHIFT);
+    release_key(2, 0);
+    release_key(3, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(LatencyTrace, NestedRecordsLeaveTheOuterKeyTraced) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+
+    // the played back A was never pressed, its reports belong to the key playing it
+    ASSERT_EQ(latency_trace_count(), 1);
+    expect_trace(0, 4, true, 0);
+}
+
+TEST_F(LatencyTrace, RingBufferKeepsTheMostRecent) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    for (int i = 0; i < LATENCY_TRACE_SIZE; i++) {
+        press_key(0, 0);
+        run_one_scan_loop();
+        release_key(0, 0);
+        run_one_scan_loop();
+    }
+
+    EXPECT_EQ(latency_trace_count(), LATENCY_TRACE_SIZE);
+    expect_trace(0, 0, false, 0);
+    EXPECT_EQ(latency_trace_get(LATENCY_TRACE_SIZE), nullptr);
+}
+
+TEST_F(LatencyTrace, RawHidQuery) {
+    TestDriver driver;
+    uint8_t    data[30] = {0};
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(1, 0);
+    idle_for(20);
+    release_key(1, 0);
+    run_one_scan_loop();
+
+    EXPECT_TRUE(latency_trace_raw_hid_query(data, sizeof(data)));
+    EXPECT_EQ(data[1], 2);
+    EXPECT_EQ(data[5], 2);
+    EXPECT_NEAR(data[7], 0, 1);    // min
+    EXPECT_NEAR(data[9], 10, 1);   // avg
+    EXPECT_NEAR(data[11], 20, 1);  // max
+
+    data[0] = 1;
+    data[1] = 0;
+    EXPECT_TRUE(latency_trace_raw_hid_query(data, sizeof(data)));
+    EXPECT_EQ(data[2], 0);
+    EXPECT_EQ(data[3], 1);
+    EXPECT_EQ(data[4], LATENCY_TRACE_DIRECT);
+    EXPECT_EQ(data[6], 0);
+    EXPECT_EQ(data[7], 0);
+    EXPECT_EQ(data[8], 1 | 0x80);
+    EXPECT_EQ(data[9], LATENCY_TRACE_TAPPING);
+    EXPECT_NEAR(data[11], 20, 1);
+    EXPECT_EQ(data[12], 0xFF);
+
+    data[0] = 2;
+    EXPECT_TRUE(latency_trace_raw_hid_query(data, sizeof(data)));
+    EXPECT_EQ(latency_trace_count(), 0);
+}
@@ -0,0 +1,120 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+// Columns of the test keymap, all on row 0
+enum { A_B, LCTL, SWAP, UNSWAP };
+
+class ResolvedActionCache : public TestFixture {
+   protected:
+    void SetUp() override {
+        dynamic_keymap_reset();
+        // written directly, without a host driver to send reports to, so the cache has to be told
+        layer_state         = 0;
+        default_layer_state = 1UL << 0;
+        keymap_config.raw   = 0;
+        clear_resolved_action_cache();
+    }
+
+    // layer changes send a report of the keys still held
+    void expect_layer_change(TestDriver &driver) { EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())); }
+
+    void tap(uint8_t col, TestDriver &driver, uint16_t keycode) {
+        press_key(col, 0);
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(keycode)));
+        run_one_scan_loop();
+        release_key(col, 0);
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(ResolvedActionCache, LayerOnAndOff) {
+    TestDriver driver;
+    InSequence s;
+
+    tap(A_B, driver, KC_A);
+    expect_layer_change(driver);
+    layer_on(1);
+    tap(A_B, driver, KC_B);
+    expect_layer_change(driver);
+    layer_off(1);
+    tap(A_B, driver, KC_A);
+}
+
+TEST_F(ResolvedActionCache, DefaultLayerSet) {
+    TestDriver driver;
+    InSequence s;
+
+    tap(A_B, driver, KC_A);
+    expect_layer_change(driver);
+    default_layer_set(1UL << 1);
+    tap(A_B, driver, KC_B);
+    // transparent on layer 1, from layer 0 below it
+    tap(LCTL, driver, KC_LCTL);
+    expect_layer_change(driver);
+    default_layer_set(1UL << 0);
+    tap(A_B, driver, KC_A);
+}
+
+TEST_F(ResolvedActionCache, DynamicKeymapSetKeycode) {
+    TestDriver driver;
+    InSequence s;
+
+    tap(A_B, driver, KC_A);
+    dynamic_keymap_set_keycode(0, 0, A_B, KC_Q);
+    tap(A_B, driver, KC_Q);
+}
+
+TEST_F(ResolvedActionCache, MagicSwap) {
+    TestDriver driver;
+    InSequence s;
+
+    tap(LCTL, driver, KC_LCTL);
+    press_key(SWAP, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    run_one_scan_loop();
+    release_key(SWAP, 0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    tap(LCTL, driver, KC_CAPS);
+}
+
+TEST_F(ResolvedActionCache, HeldKeyKeepsItsPressAction) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(A_B, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    layer_on(1);
+    // A goes up, B never went down
+    release_key(A_B, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    tap(A_B, driver, KC_B);
+    expect_layer_change(driver);
+    layer_off(1);
+}
@@ -0,0 +1,117 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "scan_profile.h"
+}
+
+using testing::_;
+
+class ScanProfile : public TestFixture {
+   protected:
+    void SetUp() override { scan_profile_reset(); }
+};
+
+TEST_F(ScanProfile, EveryScanIsRecorded) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    for (int i = 0; i < 10; i++) {
+        keyboard_task();
+    }
+
+    EXPECT_EQ(scan_profile_get_stats(SCAN_PROFILE_KEYBOARD_TASK)->count, 10u);
+    EXPECT_EQ(scan_profile_get_stats(SCAN_PROFILE_MATRIX_SCAN)->count, 10u);
+    EXPECT_EQ(scan_profile_get_stats(SCAN_PROFILE_ACTION_EXEC)->count, 10u);
+    // Not enabled in this build
+    EXPECT_EQ(scan_profile_get_stats(SCAN_PROFILE_LIGHTING)->count, 0u);
+    EXPECT_EQ(scan_profile_get_stats(SCAN_PROFILE_OLED)->count, 0u);
+}
+
+TEST_F(ScanProfile, MinAvgMax) {
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 2);
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 10);
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 6);
+
+    const scan_profile_stats_t *stats = scan_profile_get_stats(SCAN_PROFILE_DEBOUNCE);
+    EXPECT_EQ(stats->min, 2u);
+    EXPECT_EQ(stats->max, 10u);
+    EXPECT_EQ(scan_profile_get_avg(SCAN_PROFILE_DEBOUNCE), 6u);
+    EXPECT_EQ(stats->count, 3u);
+}
+
+TEST_F(ScanProfile, AverageSurvivesSumOverflow) {
+    for (int i = 0; i < 5; i++) {
+        scan_profile_record(SCAN_PROFILE_KEYBOARD_TASK, UINT32_MAX / 4);
+    }
+
+    EXPECT_EQ(scan_profile_get_avg(SCAN_PROFILE_KEYBOARD_TASK), UINT32_MAX / 4);
+}
+
+TEST_F(ScanProfile, RawHidSummary) {
+    uint8_t data[30] = {SCAN_PROFILE_DEBOUNCE, 0};
+
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 0x0102);
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 0x0304);
+
+    EXPECT_TRUE(scan_profile_raw_hid_query(data, sizeof(data)));
+    EXPECT_EQ(data[2], SCAN_PROFILE_UNIT_MILLISECONDS);
+    EXPECT_EQ(data[3], SCAN_PROFILE_PHASE_COUNT);
+    // min, avg, max and count, big endian
+    EXPECT_EQ(data[6], 0x01);
+    EXPECT_EQ(data[7], 0x02);
+    EXPECT_EQ(data[10], 0x02);
+    EXPECT_EQ(data[11], 0x03);
+    EXPECT_EQ(data[14], 0x03);
+    EXPECT_EQ(data[15], 0x04);
+    EXPECT_EQ(data[19], 2);
+}
+
+TEST_F(ScanProfile, RawHidHistogram) {
+    uint8_t data[30] = {SCAN_PROFILE_OLED, 1};
+
+    // Millisecond buckets: < 1, < 4, < 16, < 64, ...
+    scan_profile_record(SCAN_PROFILE_OLED, 0);
+    scan_profile_record(SCAN_PROFILE_OLED, 0);
+    scan_profile_record(SCAN_PROFILE_OLED, 3);
+    scan_profile_record(SCAN_PROFILE_OLED, 20);
+
+    EXPECT_TRUE(scan_profile_raw_hid_query(data, sizeof(data)));
+    EXPECT_EQ(data[2], SCAN_PROFILE_HISTOGRAM_BUCKETS);
+    EXPECT_EQ(data[5], 2);
+    EXPECT_EQ(data[7], 1);
+    EXPECT_EQ(data[9], 0);
+    EXPECT_EQ(data[11], 1);
+}
+
+TEST_F(ScanProfile, RawHidResetAndBadQueries) {
+    uint8_t data[30] = {SCAN_PROFILE_OLED, 2};
+
+    scan_profile_record(SCAN_PROFILE_OLED, 1);
+    EXPECT_TRUE(scan_profile_raw_hid_query(data, sizeof(data)));
+    EXPECT_EQ(scan_profile_get_stats(SCAN_PROFILE_OLED)->count, 0u);
+
+    data[0] = SCAN_PROFILE_PHASE_COUNT;
+    data[1] = 0;
+    EXPECT_FALSE(scan_profile_raw_hid_query(data, sizeof(data)));
+    data[0] = SCAN_PROFILE_OLED;
+    data[1] = 3;
+    EXPECT_FALSE(scan_profile_raw_hid_query(data, sizeof(data)));
+    data[1] = 0;
+    EXPECT_FALSE(scan_profile_raw_hid_query(data, 8));
+}
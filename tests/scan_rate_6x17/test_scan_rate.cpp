@@ -0,0 +1,93 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <chrono>
+#include <iostream>
+
+extern "C" {
+#include "matrix_ports.h"
+
+port_data_t test_gpio_ports[16];
+
+port_data_t test_gpio_read_port(uint8_t port) { return test_gpio_ports[port]; }
+}
+
+using testing::_;
+using testing::InSequence;
+
+class ScanRate : public TestFixture {};
+
+TEST_F(ScanRate, KeyInTheLastColumnIsReported) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(MATRIX_COLS - 1, MATRIX_ROWS - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(MATRIX_COLS - 1, MATRIX_ROWS - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ScanRate, IdleScan) {
+    TestDriver     driver;
+    const unsigned scans = 100000;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < scans; i++) {
+        keyboard_task();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << MATRIX_ROWS << "x" << MATRIX_COLS << " matrix: " << elapsed / scans << " ns per idle scan" << std::endl;
+    RecordProperty("ns_per_idle_scan", static_cast<int>(elapsed / scans));
+}
+
+TEST_F(ScanRate, ColumnReads) {
+    const unsigned reads = 100000;
+    pin_t          pins[MATRIX_COLS];
+    matrix_row_t   by_pin = 0, by_port = 0;
+
+    // Columns in order over consecutive ports, as on most boards that can use MATRIX_PORT_GROUPED_READ
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) pins[col] = TEST_PIN(col / 8, col % 8);
+    for (auto &port : test_gpio_ports) port = 0xFF;
+    matrix_ports_init(pins);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < reads; i++) {
+        test_gpio_ports[0] = i;
+        matrix_row_t row   = 0;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (!readPin(pins[col])) row |= MATRIX_ROW_SHIFTER << col;
+        }
+        by_pin ^= row;
+    }
+    auto pin_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < reads; i++) {
+        test_gpio_ports[0] = i;
+        by_port ^= matrix_ports_read_low(pins);
+    }
+    auto port_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(by_pin, by_port);
+    std::cout << MATRIX_COLS << " columns: " << pin_elapsed / reads << " ns per row read pin by pin, " << port_elapsed / reads << " ns port-grouped" << std::endl;
+    RecordProperty("ns_per_row_by_pin", static_cast<int>(pin_elapsed / reads));
+    RecordProperty("ns_per_row_by_port", static_cast<int>(port_elapsed / reads));
+}
@@ -0,0 +1,41 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+void advance_time(uint32_t ms);
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {{KC_A, KC_B, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO}},
+};
+
+// The scheduled pointing device task, counting its runs and taking as long as the test says
+uint16_t pointing_task_runs = 0;
+uint8_t  pointing_task_ms   = 0;
+
+void pointing_device_task(void) {
+    pointing_task_runs++;
+    advance_time(pointing_task_ms);
+}
+
+// The scheduled display task, standing in for the OLED driver
+uint16_t oled_task_runs = 0;
+
+bool oled_init(oled_rotation_t rotation) { return true; }
+
+bool oled_on(void) { return true; }
+
+void oled_task(void) { oled_task_runs++; }
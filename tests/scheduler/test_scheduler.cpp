@@ -0,0 +1,140 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+extern uint16_t pointing_task_runs;
+extern uint8_t  pointing_task_ms;
+extern uint16_t oled_task_runs;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class Scheduler : public TestFixture {
+   protected:
+    void SetUp() override {
+        pointing_task_runs = 0;
+        pointing_task_ms   = 0;
+        oled_task_runs     = 0;
+    }
+
+    // so the idle scans after each test leave no task deferred
+    void TearDown() override { pointing_task_ms = 0; }
+};
+
+TEST_F(Scheduler, PointingRunsEveryScanEvenWhileTyping) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    idle_for(5);
+    press_key(0, 0);
+    run_one_scan_loop();
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(pointing_task_runs, 8);
+}
+
+TEST_F(Scheduler, RunsWithinBudgetAreNotOverruns) {
+    TestDriver driver;
+    uint16_t   overruns = scheduler_get_overruns();
+
+    idle_for(5);
+    EXPECT_EQ(scheduler_get_overruns(), overruns);
+}
+
+TEST_F(Scheduler, RunsPastTheBudgetAreCounted) {
+    TestDriver driver;
+    uint16_t   overruns = scheduler_get_overruns();
+
+    // SCHEDULER_POINTING_BUDGET_US is 1 ms, 3 ms is over it even with one tick taken off
+    pointing_task_ms = 3;
+    idle_for(4);
+    EXPECT_EQ(scheduler_get_overruns(), overruns + 4);
+}
+
+TEST_F(Scheduler, TheMillisecondTimerNeverOverestimates) {
+    TestDriver driver;
+    uint16_t   overruns = scheduler_get_overruns();
+
+    // One tick passing during the run could be a moment, not a millisecond
+    pointing_task_ms = 1;
+    idle_for(4);
+    EXPECT_EQ(scheduler_get_overruns(), overruns);
+}
+
+TEST_F(Scheduler, DisplayWaitsWhileKeysAreComingIn) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(pointing_task_runs, 2);
+    EXPECT_EQ(oled_task_runs, 0);
+
+    run_one_scan_loop();
+    EXPECT_EQ(oled_task_runs, 1);
+}
+
+TEST_F(Scheduler, TasksWaitOnceTheScanBudgetIsSpent) {
+    TestDriver driver;
+
+    // pointing runs first and uses up the 1 ms scan budget
+    pointing_task_ms = 3;
+    idle_for(2);
+    EXPECT_EQ(pointing_task_runs, 2);
+    EXPECT_EQ(oled_task_runs, 0);
+
+    pointing_task_ms = 0;
+    run_one_scan_loop();
+    EXPECT_EQ(oled_task_runs, 1);
+}
+
+TEST_F(Scheduler, TasksRunAfterSchedulerMaxDeferSkips) {
+    TestDriver driver;
+
+    pointing_task_ms = 3;
+    // SCHEDULER_MAX_DEFER is 4
+    idle_for(4);
+    EXPECT_EQ(oled_task_runs, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(oled_task_runs, 1);
+    // and the count starts over
+    idle_for(4);
+    EXPECT_EQ(oled_task_runs, 1);
+    run_one_scan_loop();
+    EXPECT_EQ(oled_task_runs, 2);
+}
+
+TEST_F(Scheduler, TasksRunAfterSchedulerMaxDeferScansOfInput) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (uint8_t i = 0; i < 4; i++) {
+        press_key(0, 0);
+        run_one_scan_loop();
+        release_key(0, 0);
+        run_one_scan_loop();
+    }
+    // skipped for 4 scans, run on the 5th and skipped again since
+    EXPECT_EQ(oled_task_runs, 1);
+}
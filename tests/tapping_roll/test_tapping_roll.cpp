@@ -0,0 +1,172 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <utility>
+#include <vector>
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+
+using testing::_;
+using testing::Invoke;
+
+struct Key {
+    uint8_t col;
+    uint8_t row;
+};
+
+// Mod-taps on row 0, plain letters on rows 1 and 2
+const Key SFT_A = {0, 0}, CTL_S = {1, 0}, ALT_D = {2, 0}, GUI_F = {3, 0};
+
+// A key that was not in the previous report, with the mods it came with
+typedef std::pair<uint8_t, uint8_t> Typed;
+
+class TappingRoll : public TestFixture {
+   protected:
+    /* Records every key down sent to the host, once the keyboard is idle
+     * the tests compare it to the keys they expect, in order.
+     */
+    void record(TestDriver& driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([this](report_keyboard_t& report) {
+            for (uint8_t key : report.keys) {
+                if (key && !is_key_pressed(&last, key)) typed.push_back(Typed(report.mods, key));
+            }
+            last = report;
+        }));
+    }
+
+    /* Presses the keys one scan apart, each held until overlap more keys
+     * went down, then releases the rest.
+     */
+    void roll(const std::vector<Key>& keys, size_t overlap) {
+        for (size_t i = 0; i < keys.size(); i++) {
+            press_key(keys[i].col, keys[i].row);
+            if (i >= overlap) release_key(keys[i - overlap].col, keys[i - overlap].row);
+            run_one_scan_loop();
+        }
+        for (size_t i = keys.size() > overlap ? keys.size() - overlap : 0; i < keys.size(); i++) {
+            release_key(keys[i].col, keys[i].row);
+            run_one_scan_loop();
+        }
+    }
+
+    std::vector<Typed> typed;
+    report_keyboard_t  last = {};
+};
+
+// The 20 plain letters, in keymap order
+static std::vector<Key> letters(void) {
+    std::vector<Key> keys;
+    for (uint8_t row = 1; row <= 2; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) keys.push_back({col, row});
+    }
+    return keys;
+}
+
+static const uint8_t letter_codes[] = {KC_B, KC_C, KC_E, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_T, KC_U, KC_V, KC_W, KC_X};
+
+TEST_F(TappingRoll, RollWithModTapsIsTypedInOrder) {
+    TestDriver driver;
+    record(driver);
+
+    std::vector<Key>   keys = letters();
+    std::vector<Typed> expected;
+    for (uint8_t i = 0; i < 20; i++) expected.push_back(Typed(0, letter_codes[i]));
+    // Every fifth key is a mod-tap, tapped while the next keys already went down
+    const Key     mod_taps[]  = {SFT_A, CTL_S, ALT_D, GUI_F};
+    const uint8_t tap_codes[] = {KC_A, KC_S, KC_D, KC_F};
+    for (int i = 3; i >= 0; i--) {
+        keys.insert(keys.begin() + i * 5 + 1, mod_taps[i]);
+        expected.insert(expected.begin() + i * 5 + 1, Typed(0, tap_codes[i]));
+    }
+    keys.resize(20);
+    expected.resize(20);
+
+    roll(keys, 3);
+    idle_for(TAPPING_TERM + 1);
+    EXPECT_EQ(typed, expected);
+    EXPECT_FALSE(has_anykey(&last));
+    EXPECT_EQ(last.mods, 0);
+}
+
+TEST_F(TappingRoll, OverflowResolvesTheHeldModTapAsHold) {
+    TestDriver driver;
+    record(driver);
+
+    // All 40 events of the roll come within the tapping term
+    press_key(SFT_A.col, SFT_A.row);
+    run_one_scan_loop();
+    roll(letters(), 1);
+    ASSERT_LT(20 + 1, TAPPING_TERM);
+    release_key(SFT_A.col, SFT_A.row);
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM + 1);
+
+    // No key is lost, and the ones before the overflow got the shift too
+    std::vector<Typed> expected;
+    for (uint8_t code : letter_codes) expected.push_back(Typed(MOD_BIT(KC_LSFT), code));
+    EXPECT_EQ(typed, expected);
+    EXPECT_FALSE(has_anykey(&last));
+    EXPECT_EQ(last.mods, 0);
+}
+
+TEST_F(TappingRoll, ModTapsInsideAnOverflowingRollAreTapped) {
+    TestDriver driver;
+    record(driver);
+
+    std::vector<Key>   keys = letters();
+    std::vector<Typed> expected;
+    for (uint8_t code : letter_codes) expected.push_back(Typed(MOD_BIT(KC_LSFT), code));
+    keys.insert(keys.begin() + 12, ALT_D);
+    expected.insert(expected.begin() + 12, Typed(MOD_BIT(KC_LSFT), KC_D));
+    keys.insert(keys.begin() + 4, CTL_S);
+    expected.insert(expected.begin() + 4, Typed(MOD_BIT(KC_LSFT), KC_S));
+
+    press_key(SFT_A.col, SFT_A.row);
+    run_one_scan_loop();
+    roll(keys, 2);
+    release_key(SFT_A.col, SFT_A.row);
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM + 1);
+
+    EXPECT_EQ(typed, expected);
+    EXPECT_FALSE(has_anykey(&last));
+    EXPECT_EQ(last.mods, 0);
+}
+
+TEST_F(TappingRoll, ModTapReleasedBeforeTheBufferFillsIsATap) {
+    TestDriver driver;
+    record(driver);
+
+    std::vector<Key> keys = letters();
+    keys.resize(3);
+    press_key(SFT_A.col, SFT_A.row);
+    run_one_scan_loop();
+    for (const Key& key : keys) {
+        press_key(key.col, key.row);
+        run_one_scan_loop();
+    }
+    release_key(SFT_A.col, SFT_A.row);
+    run_one_scan_loop();
+    for (const Key& key : keys) {
+        release_key(key.col, key.row);
+        run_one_scan_loop();
+    }
+    idle_for(TAPPING_TERM + 1);
+
+    std::vector<Typed> expected = {Typed(0, KC_A), Typed(0, KC_B), Typed(0, KC_C), Typed(0, KC_E)};
+    EXPECT_EQ(typed, expected);
+}
@@ -0,0 +1,174 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "tapping_stats.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+// Columns of the test keymap, all on row 0
+enum { SFT_A, LT1_B, C, CTL_D };
+
+class TappingStats : public TestFixture {
+   protected:
+    void SetUp() override { tapping_stats_clear(); }
+
+    // The counters of one histogram, with the bin the duration falls in
+    uint8_t bin_of(uint8_t col, tapping_stats_histogram_t histogram, uint16_t duration) {
+        const uint8_t *bins = tapping_stats_get({.col = col, .row = 0}, histogram);
+        EXPECT_NE(bins, nullptr);
+        if (!bins) return 0;
+        uint16_t bin = duration / TAPPING_STATS_BIN_WIDTH;
+        return bins[bin < TAPPING_STATS_BINS ? bin : TAPPING_STATS_BINS - 1];
+    }
+
+    uint16_t total(uint8_t col, tapping_stats_histogram_t histogram) {
+        const uint8_t *bins  = tapping_stats_get({.col = col, .row = 0}, histogram);
+        uint16_t       count = 0;
+        for (uint8_t i = 0; bins && i < TAPPING_STATS_BINS; i++) count += bins[i];
+        return count;
+    }
+
+    void hold_for(uint8_t col, unsigned time) {
+        press_key(col, 0);
+        idle_for(time);
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(TappingStats, TapCountsHowLongTheKeyWasHeld) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    hold_for(SFT_A, 60);
+    EXPECT_EQ(bin_of(SFT_A, TAPPING_STATS_TAP_HELD, 60), 1);
+    EXPECT_EQ(total(SFT_A, TAPPING_STATS_TAP_HELD), 1);
+    EXPECT_EQ(total(SFT_A, TAPPING_STATS_HOLD_HELD), 0);
+    EXPECT_EQ(total(SFT_A, TAPPING_STATS_TAP_OVERLAP), 0);
+}
+
+TEST_F(TappingStats, HoldCountsHowLongTheKeyWasHeld) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    hold_for(SFT_A, TAPPING_TERM + 60);
+    EXPECT_EQ(bin_of(SFT_A, TAPPING_STATS_HOLD_HELD, TAPPING_TERM + 60), 1);
+    EXPECT_EQ(total(SFT_A, TAPPING_STATS_TAP_HELD), 0);
+}
+
+TEST_F(TappingStats, LongDurationsGoInTheLastBin) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    hold_for(SFT_A, TAPPING_STATS_BINS * TAPPING_STATS_BIN_WIDTH * 2);
+    EXPECT_EQ(tapping_stats_get({.col = SFT_A, .row = 0}, TAPPING_STATS_HOLD_HELD)[TAPPING_STATS_BINS - 1], 1);
+}
+
+TEST_F(TappingStats, InterruptedModTapCountsAsAHoldWithItsOverlap) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    // A roll: without IGNORE_MOD_TAP_INTERRUPT the mod-tap turns into a hold
+    press_key(SFT_A, 0);
+    idle_for(20);
+    press_key(C, 0);
+    idle_for(40);
+    release_key(SFT_A, 0);
+    run_one_scan_loop();
+    release_key(C, 0);
+    // The releases wait in the buffer until the tapping term ends
+    idle_for(TAPPING_TERM);
+
+    EXPECT_EQ(bin_of(SFT_A, TAPPING_STATS_HOLD_HELD, 60), 1);
+    EXPECT_EQ(bin_of(SFT_A, TAPPING_STATS_HOLD_OVERLAP, 40), 1);
+    EXPECT_EQ(total(SFT_A, TAPPING_STATS_TAP_HELD), 0);
+    // Only tap-hold keys are tracked
+    EXPECT_EQ(tapping_stats_count(), 1);
+}
+
+TEST_F(TappingStats, RolledLayerTapCountsAsATapWithItsOverlap) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    press_key(LT1_B, 0);
+    idle_for(20);
+    press_key(C, 0);
+    idle_for(40);
+    release_key(LT1_B, 0);
+    run_one_scan_loop();
+    release_key(C, 0);
+    run_one_scan_loop();
+
+    EXPECT_EQ(bin_of(LT1_B, TAPPING_STATS_TAP_HELD, 60), 1);
+    EXPECT_EQ(bin_of(LT1_B, TAPPING_STATS_TAP_OVERLAP, 40), 1);
+    EXPECT_EQ(total(LT1_B, TAPPING_STATS_HOLD_HELD), 0);
+}
+
+TEST_F(TappingStats, FullCountersAreHalved) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (int i = 0; i < 256; i++) {
+        hold_for(SFT_A, 10);
+        // no sequential taps
+        idle_for(TAPPING_TERM);
+    }
+    EXPECT_EQ(bin_of(SFT_A, TAPPING_STATS_TAP_HELD, 10), 128);
+}
+
+TEST_F(TappingStats, RawHidQueries) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    hold_for(SFT_A, 60);
+    hold_for(LT1_B, TAPPING_TERM + 60);
+    // Past TAPPING_STATS_KEYS
+    hold_for(CTL_D, 60);
+
+    uint8_t data[30] = {0};
+    ASSERT_TRUE(tapping_stats_raw_hid_query(data, sizeof(data)));
+    EXPECT_EQ(data[1], 2);
+    EXPECT_EQ(data[2], 1);
+    EXPECT_EQ(data[3], TAPPING_STATS_BINS);
+    EXPECT_EQ((data[4] << 8) | data[5], TAPPING_STATS_BIN_WIDTH);
+
+    memset(data, 0, sizeof(data));
+    data[0] = 1;
+    data[1] = 1;
+    data[2] = TAPPING_STATS_HOLD_HELD;
+    ASSERT_TRUE(tapping_stats_raw_hid_query(data, sizeof(data)));
+    EXPECT_EQ(data[3], 0);
+    EXPECT_EQ(data[4], LT1_B);
+    EXPECT_EQ(data[5 + (TAPPING_TERM + 60) / TAPPING_STATS_BIN_WIDTH], 1);
+
+    data[0] = 1;
+    data[1] = 2;
+    ASSERT_TRUE(tapping_stats_raw_hid_query(data, sizeof(data)));
+    EXPECT_EQ(data[3], 0xFF);
+    EXPECT_EQ(data[4], 0xFF);
+
+    data[0] = 2;
+    ASSERT_TRUE(tapping_stats_raw_hid_query(data, sizeof(data)));
+    EXPECT_EQ(tapping_stats_count(), 0);
+
+    data[0] = 3;
+    EXPECT_FALSE(tapping_stats_raw_hid_query(data, sizeof(data)));
+}
@@ -19,6 +19,7 @@
 #include <string.h>
 
 static matrix_row_t matrix[MATRIX_ROWS] = {};
+static matrix_row_t matrix_scanned[MATRIX_ROWS] = {};
 
 void matrix_init(void) {
     clear_all_keys();
@@ -26,8 +27,11 @@ void matrix_init(void) {
 }
 
 uint8_t matrix_scan(void) {
+    // like a real matrix, only report a change when keys went up or down since the last scan
+    bool changed = memcmp(matrix_scanned, matrix, sizeof(matrix)) != 0;
+    memcpy(matrix_scanned, matrix, sizeof(matrix));
     matrix_scan_quantum();
-    return 1;
+    return changed;
 }
 
 matrix_row_t matrix_get_row(uint8_t row) { return matrix[row]; }
@@ -38,9 +42,9 @@ void matrix_init_kb(void) {}
 
 void matrix_scan_kb(void) {}
 
-void press_key(uint8_t col, uint8_t row) { matrix[row] |= 1 << col; }
+void press_key(uint8_t col, uint8_t row) { matrix[row] |= MATRIX_ROW_SHIFTER << col; }
 
-void release_key(uint8_t col, uint8_t row) { matrix[row] &= ~(1 << col); }
+void release_key(uint8_t col, uint8_t row) { matrix[row] &= ~(MATRIX_ROW_SHIFTER << col); }
 
 void clear_all_keys(void) { memset(matrix, 0, sizeof(matrix)); }
 
@@ -16,6 +16,7 @@ TMK_COMMON_SRC +=	$(COMMON_DIR)/host.c \
 	$(PLATFORM_COMMON_DIR)/suspend.c \
 	$(PLATFORM_COMMON_DIR)/timer.c \
 	$(COMMON_DIR)/sync_timer.c \
+	$(COMMON_DIR)/deadline.c \
 	$(PLATFORM_COMMON_DIR)/bootloader.c \
 
 # Use platform provided print - fall back to lib/printf
@@ -82,6 +83,16 @@ ifeq ($(strip $(SLEEP_LED_ENABLE)), yes)
     TMK_COMMON_DEFS += -DNO_SUSPEND_POWER_DOWN
 endif
 
+ifeq ($(strip $(LATENCY_TRACE_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/latency_trace.c
+    TMK_COMMON_DEFS += -DLATENCY_TRACE_ENABLE
+endif
+
+ifeq ($(strip $(TAPPING_STATS_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/tapping_stats.c
+    TMK_COMMON_DEFS += -DTAPPING_STATS_ENABLE
+endif
+
 ifeq ($(strip $(NO_SUSPEND_POWER_DOWN)), yes)
     TMK_COMMON_DEFS += -DNO_SUSPEND_POWER_DOWN
 endif
@@ -26,6 +26,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_util.h"
 #include "action.h"
 #include "wait.h"
+#include "latency_trace.h"
+#include "tapping_stats.h"
 
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
@@ -66,6 +68,7 @@ __attribute__((weak)) bool get_retro_tapping(uint16_t keycode, keyrecord_t *reco
  * FIXME: Needs documentation.
  */
 void action_exec(keyevent_t event) {
+    latency_trace_event(event);
     if (!IS_NOEVENT(event)) {
         dprint("\n---- action_exec: start -----\n");
         dprint("EVENT: ");
@@ -105,6 +108,11 @@ void action_exec(keyevent_t event) {
 #    endif
 #endif
 
+    // Key events held back here, like combo keys, are replayed later on
+    if (!IS_NOEVENT(record.event) && !pre_process_record_quantum(&record)) {
+        return;
+    }
+
 #ifndef NO_ACTION_TAPPING
     action_tapping_process(record);
 #else
@@ -154,6 +162,8 @@ void process_record_nocache(keyrecord_t *record) {
 void process_record_nocache(keyrecord_t *record) { process_record(record); }
 #endif
 
+__attribute__((weak)) bool pre_process_record_quantum(keyrecord_t *record) { return true; }
+
 __attribute__((weak)) bool process_record_quantum(keyrecord_t *record) { return true; }
 
 __attribute__((weak)) void post_process_record_quantum(keyrecord_t *record) {}
@@ -192,17 +202,21 @@ void process_record(keyrecord_t *record) {
         return;
     }
 
+    tapping_stats_record(record);
+    latency_trace_process_begin(&record->event);
     if (!process_record_quantum(record)) {
 #ifndef NO_ACTION_ONESHOT
         if (is_oneshot_layer_active() && record->event.pressed) {
             clear_oneshot_layer_state(ONESHOT_OTHER_KEY_PRESSED);
         }
 #endif
+        latency_trace_process_end();
         return;
     }
 
     process_record_handler(record);
     post_process_record_quantum(record);
+    latency_trace_process_end();
 }
 
 void process_record_handler(keyrecord_t *record) {
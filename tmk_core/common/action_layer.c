@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
 #include "action.h"
 #include "util.h"
@@ -38,6 +39,7 @@ static void default_layer_state_set(layer_state_t state) {
     default_layer_state = state;
     default_layer_debug();
     debug("\n");
+    clear_resolved_action_cache();
 #ifdef STRICT_LAYER_RELEASE
     clear_keyboard_but_mods();  // To avoid stuck keys
 #else
@@ -104,6 +106,7 @@ void layer_state_set(layer_state_t state) {
     layer_state = state;
     layer_debug();
     dprintln();
+    clear_resolved_action_cache();
 #    ifdef STRICT_LAYER_RELEASE
     clear_keyboard_but_mods();  // To avoid stuck keys
 #    else
@@ -219,6 +222,77 @@ uint8_t read_source_layers_cache(keypos_t key) {
 }
 #endif
 
+#if !defined(NO_ACTION_LAYER) && defined(RESOLVED_ACTION_CACHE)
+/** \brief resolved action cache
+ *
+ * Layer and action each key resolves to with the current layer state, so a
+ * lookup doesn't have to walk the layers again until the layer state or keymap changes.
+ */
+typedef struct {
+    action_t action;
+    uint8_t  layer;
+} resolved_action_t;
+
+static resolved_action_t resolved_action_cache[MATRIX_ROWS * MATRIX_COLS];
+static uint8_t           resolved_action_cache_valid[(MATRIX_ROWS * MATRIX_COLS + 7) / 8] = {0};
+static uint32_t          resolved_action_cache_hits                                      = 0;
+static uint32_t          resolved_action_cache_misses                                    = 0;
+
+/** \brief clear resolved action cache
+ *
+ * Must be called whenever the result of action_for_key() may change: layer state, keymap or keymap config.
+ * The core does this for its own writes; a keyboard or user keymap_key_to_keycode() override whose
+ * result changes, or code that writes layer_state, default_layer_state or keymap_config directly,
+ * has to call it itself.
+ */
+void clear_resolved_action_cache(void) { memset(resolved_action_cache_valid, 0, sizeof(resolved_action_cache_valid)); }
+
+/** \brief resolved action cache debug printing
+ *
+ * Print out the cache hit and miss counters.
+ */
+void resolved_action_cache_debug(void) { xprintf("resolved action cache: %lu hits, %lu misses\n", resolved_action_cache_hits, resolved_action_cache_misses); }
+#endif
+
+#ifndef NO_ACTION_LAYER
+/** \brief Layer switch resolve
+ *
+ * Finds the highest active layer with a non-transparent action for the key
+ */
+static uint8_t layer_switch_resolve(keypos_t key, action_t *action) {
+    layer_state_t layers = layer_state | default_layer_state;
+    /* check top layer first */
+    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+        if (layers & (1UL << i)) {
+            *action = action_for_key(i, key);
+            if (action->code != ACTION_TRANSPARENT) {
+                return i;
+            }
+        }
+    }
+    /* fall back to layer 0 */
+    *action = action_for_key(0, key);
+    return 0;
+}
+
+#    ifdef RESOLVED_ACTION_CACHE
+static const resolved_action_t *get_resolved_action(keypos_t key) {
+    const uint16_t     key_number  = key.col + (key.row * MATRIX_COLS);
+    const uint8_t      storage_bit = 1U << (key_number % 8);
+    resolved_action_t *entry       = &resolved_action_cache[key_number];
+
+    if (resolved_action_cache_valid[key_number / 8] & storage_bit) {
+        resolved_action_cache_hits++;
+    } else {
+        resolved_action_cache_misses++;
+        entry->layer = layer_switch_resolve(key, &entry->action);
+        resolved_action_cache_valid[key_number / 8] |= storage_bit;
+    }
+    return entry;
+}
+#    endif
+#endif
+
 /** \brief Store or get action (FIXME: Needs better summary)
  *
  * Make sure the action triggered when the key is released is the same
@@ -235,8 +309,14 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
     uint8_t layer;
 
     if (pressed) {
+#    ifdef RESOLVED_ACTION_CACHE
+        const resolved_action_t *resolved = get_resolved_action(key);
+        update_source_layers_cache(key, resolved->layer);
+        return resolved->action;
+#    else
         layer = layer_switch_get_layer(key);
         update_source_layers_cache(key, layer);
+#    endif
     } else {
         layer = read_source_layers_cache(key);
     }
@@ -252,21 +332,12 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
  */
 uint8_t layer_switch_get_layer(keypos_t key) {
 #ifndef NO_ACTION_LAYER
+#    ifdef RESOLVED_ACTION_CACHE
+    return get_resolved_action(key)->layer;
+#    else
     action_t action;
-    action.code = ACTION_TRANSPARENT;
-
-    layer_state_t layers = layer_state | default_layer_state;
-    /* check top layer first */
-    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
-        if (layers & (1UL << i)) {
-            action = action_for_key(i, key);
-            if (action.code != ACTION_TRANSPARENT) {
-                return i;
-            }
-        }
-    }
-    /* fall back to layer 0 */
-    return 0;
+    return layer_switch_resolve(key, &action);
+#    endif
 #else
     return get_highest_layer(default_layer_state);
 #endif
@@ -276,4 +347,10 @@ uint8_t layer_switch_get_layer(keypos_t key) {
  *
  * Gets action code based on key position
  */
-action_t layer_switch_get_action(keypos_t key) { return action_for_key(layer_switch_get_layer(key), key); }
+action_t layer_switch_get_action(keypos_t key) {
+#if !defined(NO_ACTION_LAYER) && defined(RESOLVED_ACTION_CACHE)
+    return get_resolved_action(key)->action;
+#else
+    return action_for_key(layer_switch_get_layer(key), key);
+#endif
+}
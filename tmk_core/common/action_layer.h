@@ -108,6 +108,14 @@ layer_state_t layer_state_set_kb(layer_state_t state);
 #endif
 
 /* pressed actions cache */
+#if !defined(NO_ACTION_LAYER) && defined(RESOLVED_ACTION_CACHE)
+void clear_resolved_action_cache(void);
+void resolved_action_cache_debug(void);
+#else
+#    define clear_resolved_action_cache()
+#    define resolved_action_cache_debug()
+#endif
+
 #if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
 
 void    update_source_layers_cache(keypos_t key, uint8_t layer);
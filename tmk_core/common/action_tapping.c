@@ -1,3 +1,4 @@
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "action.h"
@@ -5,6 +6,7 @@
 #include "action_tapping.h"
 #include "keycode.h"
 #include "timer.h"
+#include "deadline.h"
 
 #ifdef DEBUG_ACTION
 #    include "debug.h"
@@ -35,6 +37,9 @@ __attribute__((weak)) bool get_tapping_force_hold(uint16_t keycode, keyrecord_t
 __attribute__((weak)) bool get_permissive_hold(uint16_t keycode, keyrecord_t *record) { return false; }
 #    endif
 
+// Wraps without a division, WAITING_BUFFER_SIZE does not have to be a power of two
+#    define WAITING_BUFFER_NEXT(i) ((uint8_t)((i) + 1 == WAITING_BUFFER_SIZE ? 0 : (i) + 1))
+
 static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t     waiting_buffer_head                 = 0;
@@ -42,7 +47,9 @@ static uint8_t     waiting_buffer_tail                 = 0;
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
-static void waiting_buffer_clear(void);
+static void waiting_buffer_process(void);
+static void waiting_buffer_settle(void);
+static void tapping_set_deadline(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
 static void waiting_buffer_scan_tap(void);
@@ -61,12 +68,9 @@ void action_tapping_process(keyrecord_t record) {
             debug("\n");
         }
     } else {
-        if (!waiting_buffer_enq(record)) {
-            // clear all in case of overflow.
-            debug("OVERFLOW: CLEAR ALL STATES\n");
-            clear_keyboard();
-            waiting_buffer_clear();
-            tapping_key = (keyrecord_t){};
+        // make room by settling the tapping key instead of dropping events
+        while (!waiting_buffer_enq(record)) {
+            waiting_buffer_settle();
         }
     }
 
@@ -74,22 +78,38 @@ void action_tapping_process(keyrecord_t record) {
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
-            debug("processed: waiting_buffer[");
-            debug_dec(waiting_buffer_tail);
-            debug("] = ");
-            debug_record(waiting_buffer[waiting_buffer_tail]);
-            debug("\n\n");
-        } else {
-            break;
-        }
-    }
+    waiting_buffer_process();
     if (!IS_NOEVENT(record.event)) {
         debug("\n");
     }
+    tapping_set_deadline();
+}
+
+/** \brief Tapping deadline
+ *
+ * Arms the tick for the end of the tapping term, when it would settle the
+ * tapping key: an undecided key is resolved as a hold, a released one stops
+ * waiting for the next tap. Otherwise a tick changes nothing.
+ */
+static void tapping_set_deadline(void) {
+    if ((IS_TAPPING_PRESSED() && tapping_key.tap.count == 0) || IS_TAPPING_RELEASED()) {
+#    ifdef TAPPING_TERM_PER_KEY
+        uint16_t term = get_tapping_term(get_event_keycode(tapping_key.event, false), &tapping_key);
+#    else
+        uint16_t term = TAPPING_TERM;
+#    endif
+        deadline_set(DEADLINE_TAPPING, tapping_key.event.time + term);
+    } else {
+        deadline_clear(DEADLINE_TAPPING);
+    }
 }
 
+/** \brief The tap-hold key pressed and not decided yet, if any
+ *
+ * Until it is, the layer keys pressed after it will come from is not known.
+ */
+const keyrecord_t *get_undecided_tapping_key(void) { return IS_TAPPING_PRESSED() && tapping_key.tap.count == 0 ? &tapping_key : NULL; }
+
 /** \brief Tapping
  *
  * Rule: Tap key is typed(pressed and released) within TAPPING_TERM.
@@ -319,33 +339,60 @@ bool process_tapping(keyrecord_t *keyp) {
 
 /** \brief Waiting buffer enq
  *
- * FIXME: Needs docs
+ * Returns false when the buffer is full, one slot is always left free.
  */
 bool waiting_buffer_enq(keyrecord_t record) {
     if (IS_NOEVENT(record.event)) {
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if (WAITING_BUFFER_NEXT(waiting_buffer_head) == waiting_buffer_tail) {
         debug("waiting_buffer_enq: Over flow.\n");
         return false;
     }
 
     waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_head                 = WAITING_BUFFER_NEXT(waiting_buffer_head);
 
     debug("waiting_buffer_enq: ");
     debug_waiting_buffer();
     return true;
 }
 
-/** \brief Waiting buffer clear
+/** \brief Waiting buffer process
  *
- * FIXME: Needs docs
+ * Dequeues the buffered events in order, up to the first one the tapping
+ * key still has to wait for.
+ */
+void waiting_buffer_process(void) {
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail)) {
+        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+            debug("processed: waiting_buffer[");
+            debug_dec(waiting_buffer_tail);
+            debug("] = ");
+            debug_record(waiting_buffer[waiting_buffer_tail]);
+            debug("\n\n");
+        } else {
+            break;
+        }
+    }
+}
+
+/** \brief Waiting buffer settle
+ *
+ * Called when the buffer is full: events only wait for an undecided tapping
+ * key, which has now been held through a whole buffer of other events, so
+ * it is resolved as a hold, as if its tapping term had run out. The events
+ * behind it are then processed, which frees at least one slot.
  */
-void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+void waiting_buffer_settle(void) {
+    debug("waiting_buffer_settle: ");
+    debug_tapping_key();
+    if (IS_TAPPING_PRESSED() && tapping_key.tap.count == 0) {
+        process_record(&tapping_key);
+    }
+    tapping_key = (keyrecord_t){};
+    waiting_buffer_process();
 }
 
 /** \brief Waiting buffer typed
@@ -353,7 +400,7 @@ void waiting_buffer_clear(void) {
  * FIXME: Needs docs
  */
 bool waiting_buffer_typed(keyevent_t event) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
             return true;
         }
@@ -366,7 +413,7 @@ bool waiting_buffer_typed(keyevent_t event) {
  * FIXME: Needs docs
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (waiting_buffer[i].event.pressed) return true;
     }
     return false;
@@ -382,7 +429,7 @@ void waiting_buffer_scan_tap(void) {
     // invalid state: tapping_key released && tap.count == 0
     if (!tapping_key.event.pressed) return;
 
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (IS_TAPPING_KEY(waiting_buffer[i].event.key) && !waiting_buffer[i].event.pressed && WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
             tapping_key.tap.count       = 1;
             waiting_buffer[i].tap.count = 1;
@@ -413,7 +460,7 @@ static void debug_tapping_key(void) {
  */
 static void debug_waiting_buffer(void) {
     debug("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         debug("[");
         debug_dec(i);
         debug("]=");
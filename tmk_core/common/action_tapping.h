@@ -27,12 +27,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define TAPPING_TOGGLE 5
 #endif
 
-#define WAITING_BUFFER_SIZE 8
+/* events held back while a tap key is undecided, one slot is left free.
+ * When it fills up, the tap key is resolved as a hold. */
+#ifndef WAITING_BUFFER_SIZE
+#    define WAITING_BUFFER_SIZE 8
+#endif
+#if WAITING_BUFFER_SIZE < 2 || WAITING_BUFFER_SIZE > 255
+#    error "WAITING_BUFFER_SIZE must be between 2 and 255"
+#endif
 
 #ifndef NO_ACTION_TAPPING
 uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache);
 void     action_tapping_process(keyrecord_t record);
 
+const keyrecord_t *get_undecided_tapping_key(void);
+
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
 bool     get_permissive_hold(uint16_t keycode, keyrecord_t *record);
 bool     get_ignore_mod_tap_interrupt(uint16_t keycode, keyrecord_t *record);
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_util.h"
 #include "action_layer.h"
 #include "timer.h"
+#include "deadline.h"
 #include "keycode_config.h"
 
 extern keymap_config_t keymap_config;
@@ -99,6 +100,41 @@ inline bool     has_oneshot_layer_timed_out() { return TIMER_DIFF_16(timer_read(
 static uint16_t oneshot_swaphands_time = 0;
 inline bool     has_oneshot_swaphands_timed_out() { return TIMER_DIFF_16(timer_read(), oneshot_swaphands_time) >= ONESHOT_TIMEOUT && (swap_hands_oneshot == SHO_ACTIVE); }
 #        endif
+
+/** \brief Arms the one shot deadline for the earliest timeout still running
+ *
+ * Called whenever a one shot starts or ends, action_exec() is ticked once the
+ * deadline passes to time it out. Only the states a timeout clears count.
+ */
+static void oneshot_set_deadline(void) {
+    uint16_t now     = timer_read();
+    bool     running = false;
+    uint16_t elapsed = 0;  // since the earliest start
+    if (oneshot_mods) {
+        running = true;
+        elapsed = TIMER_DIFF_16(now, oneshot_time);
+    }
+    if ((oneshot_layer_data & ONESHOT_OTHER_KEY_PRESSED) && !(oneshot_layer_data & ONESHOT_TOGGLED)) {
+        uint16_t layer_elapsed = TIMER_DIFF_16(now, oneshot_layer_time);
+        if (!running || layer_elapsed > elapsed) elapsed = layer_elapsed;
+        running = true;
+    }
+#        ifdef SWAP_HANDS_ENABLE
+    if (swap_hands_oneshot == SHO_ACTIVE) {
+        uint16_t swaphands_elapsed = TIMER_DIFF_16(now, oneshot_swaphands_time);
+        if (!running || swaphands_elapsed > elapsed) elapsed = swaphands_elapsed;
+        running = true;
+    }
+#        endif
+
+    if (running) {
+        deadline_set(DEADLINE_ONESHOT, now + (elapsed < ONESHOT_TIMEOUT ? ONESHOT_TIMEOUT - elapsed : 0));
+    } else {
+        deadline_clear(DEADLINE_ONESHOT);
+    }
+}
+#    else
+#        define oneshot_set_deadline()
 #    endif
 
 #    ifdef SWAP_HANDS_ENABLE
@@ -112,6 +148,7 @@ void set_oneshot_swaphands(void) {
         oneshot_layer_time = oneshot_swaphands_time;
     }
 #        endif
+    oneshot_set_deadline();
 }
 
 void release_oneshot_swaphands(void) {
@@ -121,6 +158,7 @@ void release_oneshot_swaphands(void) {
     if (swap_hands_oneshot == SHO_USED) {
         clear_oneshot_swaphands();
     }
+    oneshot_set_deadline();
 }
 
 void use_oneshot_swaphands(void) {
@@ -138,6 +176,7 @@ void clear_oneshot_swaphands(void) {
 #        if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
     oneshot_swaphands_time = 0;
 #        endif
+    oneshot_set_deadline();
 }
 
 #    endif
@@ -153,6 +192,7 @@ void set_oneshot_layer(uint8_t layer, uint8_t state) {
 #    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
         oneshot_layer_time = timer_read();
 #    endif
+        oneshot_set_deadline();
         oneshot_layer_changed_kb(get_oneshot_layer());
     } else {
         layer_on(layer);
@@ -167,6 +207,7 @@ void reset_oneshot_layer(void) {
 #    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
     oneshot_layer_time = 0;
 #    endif
+    oneshot_set_deadline();
     oneshot_layer_changed_kb(get_oneshot_layer());
 }
 /** \brief Clear oneshot layer
@@ -180,6 +221,7 @@ void clear_oneshot_layer_state(oneshot_fullfillment_t state) {
         layer_off(get_oneshot_layer());
         reset_oneshot_layer();
     }
+    oneshot_set_deadline();
 }
 /** \brief Is oneshot layer active
  *
@@ -339,6 +381,7 @@ void add_oneshot_mods(uint8_t mods) {
         oneshot_time = timer_read();
 #    endif
         oneshot_mods |= mods;
+        oneshot_set_deadline();
         oneshot_mods_changed_kb(mods);
     }
 }
@@ -349,6 +392,7 @@ void del_oneshot_mods(uint8_t mods) {
 #    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
         oneshot_time = oneshot_mods ? timer_read() : 0;
 #    endif
+        oneshot_set_deadline();
         oneshot_mods_changed_kb(oneshot_mods);
     }
 }
@@ -364,6 +408,7 @@ void set_oneshot_mods(uint8_t mods) {
             oneshot_time = timer_read();
 #    endif
             oneshot_mods = mods;
+            oneshot_set_deadline();
             oneshot_mods_changed_kb(mods);
         }
     }
@@ -379,6 +424,7 @@ void clear_oneshot_mods(void) {
 #    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
         oneshot_time = 0;
 #    endif
+        oneshot_set_deadline();
         oneshot_mods_changed_kb(oneshot_mods);
     }
 }
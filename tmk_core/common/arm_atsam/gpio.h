@@ -69,3 +69,10 @@ typedef uint8_t pin_t;
 #define readPin(pin) ((PORT->Group[SAMD_PORT(pin)].IN.reg & SAMD_PIN_MASK(pin)) != 0)
 
 #define togglePin(pin) (PORT->Group[SAMD_PORT(pin)].OUTTGL.reg = SAMD_PIN_MASK(pin))
+
+/* Whole-port access, for reading several pins at once */
+typedef uint32_t port_data_t;
+
+#define readPort(pin) (PORT->Group[SAMD_PORT(pin)].IN.reg)
+#define samePort(pin_a, pin_b) (SAMD_PORT(pin_a) == SAMD_PORT(pin_b))
+#define pinPortMask(pin) ((port_data_t)SAMD_PIN_MASK(pin))
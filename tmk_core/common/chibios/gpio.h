@@ -32,3 +32,10 @@ typedef ioline_t pin_t;
 #define readPin(pin) palReadLine(pin)
 
 #define togglePin(pin) palToggleLine(pin)
+
+/* Whole-port access, for reading several pins at once */
+typedef ioportmask_t port_data_t;
+
+#define readPort(pin) palReadPort(PAL_PORT(pin))
+#define samePort(pin_a, pin_b) (PAL_PORT(pin_a) == PAL_PORT(pin_b))
+#define pinPortMask(pin) ((port_data_t)1 << PAL_PAD(pin))
@@ -0,0 +1,37 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "deadline.h"
+#include "timer.h"
+
+static uint16_t deadlines[DEADLINE_COUNT];
+static uint8_t  armed = 0;  // one bit per deadline
+
+void deadline_set(deadline_id_t id, uint16_t time) {
+    deadlines[id] = time;
+    armed |= 1 << id;
+}
+
+void deadline_clear(deadline_id_t id) { armed &= ~(1 << id); }
+
+bool deadline_armed(deadline_id_t id) { return armed & (1 << id); }
+
+/** \brief Whether the deadline is armed and the time of an event now would reach it
+ */
+bool deadline_passed(deadline_id_t id) {
+    if (!(armed & (1 << id))) return false;
+    return TIMER_DIFF_16(timer_read() | 1, deadlines[id]) < 0x8000;
+}
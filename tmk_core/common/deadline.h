@@ -0,0 +1,51 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Deadlines of the timeouts that key processing waits for.
+ *
+ * Instead of being polled on every scan, a feature waiting for a timeout
+ * arms its deadline, and keyboard_task() only calls into it once the
+ * deadline has passed. A deadline is a time as given to key events,
+ * timer_read() | 1, and has passed once that time reaches it. Deadlines are
+ * 16 bits wide, so they have to lie less than 32 seconds ahead.
+ */
+
+typedef enum {
+    DEADLINE_TAPPING,     // tap-hold key decision, ticks action_exec()
+    DEADLINE_ONESHOT,     // earliest one shot timeout, ticks action_exec()
+    DEADLINE_TAP_DANCE,   // matrix_scan_tap_dance()
+    DEADLINE_COMBO,       // matrix_scan_combo()
+    DEADLINE_AUTO_SHIFT,  // autoshift_matrix_scan()
+    DEADLINE_COUNT,
+} deadline_id_t;
+
+void deadline_set(deadline_id_t id, uint16_t time);
+void deadline_clear(deadline_id_t id);
+bool deadline_armed(deadline_id_t id);
+bool deadline_passed(deadline_id_t id);
+
+#ifdef __cplusplus
+}
+#endif
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "util.h"
 #include "debug.h"
+#include "latency_trace.h"
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -63,6 +64,7 @@ void host_keyboard_send(report_keyboard_t *report) {
 #endif
     }
     (*driver->send_keyboard)(report);
+    latency_trace_report_sent();
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "keycode.h"
 #include "timer.h"
 #include "sync_timer.h"
+#include "deadline.h"
 #include "print.h"
 #include "debug.h"
 #include "command.h"
@@ -31,6 +32,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "scan_profile.h"
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -91,6 +93,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef VIA_ENABLE
 #    include "via.h"
 #endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+#    include "dynamic_keymap.h"
+#endif
+#if defined(KEYBOARD_TASK_SCHEDULER) && defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#    include "platform_deps.h"
+#endif
 #ifdef DIP_SWITCH_ENABLE
 #    include "dip_switch.h"
 #endif
@@ -100,6 +109,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef EEPROM_DRIVER
 #    include "eeprom_driver.h"
 #endif
+#ifdef SPLIT_KEY_EVENTS
+#    include "split_key_events.h"
+// keys of the slave half carry the time the slave saw them change
+#    define KEY_EVENT_TIME(row, col, scan_time) split_key_events_time(row, col, scan_time)
+#else
+#    define KEY_EVENT_TIME(row, col, scan_time) (scan_time)
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) { return last_input_modification_time; }
@@ -140,6 +156,16 @@ uint32_t get_matrix_scan_rate(void) { return last_matrix_scan_count; }
 #    define matrix_scan_perf_task()
 #endif
 
+/** \brief Column index of the lowest set bit in a (non-zero) matrix row
+ */
+static inline uint8_t matrix_row_lowest_col(matrix_row_t bits) {
+#if (MATRIX_COLS <= 16)
+    return __builtin_ctz(bits);
+#else
+    return __builtin_ctzl(bits);
+#endif
+}
+
 #ifdef MATRIX_HAS_GHOST
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
 static matrix_row_t   get_real_keys(uint8_t row, matrix_row_t rowdata) {
@@ -289,6 +315,164 @@ void housekeeping_task(void) {
     housekeeping_task_user();
 }
 
+#if defined(RGBLIGHT_ENABLE) || defined(LED_MATRIX_ENABLE) || defined(RGB_MATRIX_ENABLE)
+#    define LIGHTING_TASK
+/** \brief Runs the lighting effects
+ */
+static void lighting_task(void) {
+    SCAN_PROFILE_START(lighting_start);
+#    if defined(RGBLIGHT_ENABLE)
+    rgblight_task();
+#    endif
+#    ifdef LED_MATRIX_ENABLE
+    led_matrix_task();
+#    endif
+#    ifdef RGB_MATRIX_ENABLE
+    rgb_matrix_task();
+#    endif
+    SCAN_PROFILE_END(SCAN_PROFILE_LIGHTING, lighting_start);
+}
+#endif
+
+#ifdef OLED_DRIVER_ENABLE
+/** \brief Renders and flushes the OLED
+ */
+static void display_task(void) {
+    SCAN_PROFILE_START(oled_start);
+    oled_task();
+    SCAN_PROFILE_END(SCAN_PROFILE_OLED, oled_start);
+}
+#endif
+
+#ifdef KEYBOARD_TASK_SCHEDULER
+// Microseconds per scan for the tasks below, once input has been handled
+#    ifndef SCHEDULER_SCAN_BUDGET_US
+#        define SCHEDULER_SCAN_BUDGET_US 1000
+#    endif
+// Scans a task can be put off for in a row
+#    ifndef SCHEDULER_MAX_DEFER
+#        define SCHEDULER_MAX_DEFER 10
+#    endif
+#    ifndef SCHEDULER_POINTING_PRIORITY
+#        define SCHEDULER_POINTING_PRIORITY 0
+#    endif
+#    ifndef SCHEDULER_POINTING_BUDGET_US
+#        define SCHEDULER_POINTING_BUDGET_US 1000
+#    endif
+#    ifndef SCHEDULER_LIGHTING_PRIORITY
+#        define SCHEDULER_LIGHTING_PRIORITY 1
+#    endif
+#    ifndef SCHEDULER_LIGHTING_BUDGET_US
+#        define SCHEDULER_LIGHTING_BUDGET_US 2000
+#    endif
+#    ifndef SCHEDULER_OLED_PRIORITY
+#        define SCHEDULER_OLED_PRIORITY 2
+#    endif
+#    ifndef SCHEDULER_OLED_BUDGET_US
+#        define SCHEDULER_OLED_BUDGET_US 5000
+#    endif
+
+#    if defined(POINTING_DEVICE_ENABLE) || defined(LIGHTING_TASK) || defined(OLED_DRIVER_ENABLE)
+#        if defined(PROTOCOL_CHIBIOS) && (PORT_SUPPORTS_RT == TRUE)
+// The realtime counter runs at the CPU clock
+static uint32_t scheduler_read(void) { return chSysGetRealtimeCounterX(); }
+
+static uint32_t scheduler_elapsed_us(uint32_t start) { return RTC2US(STM32_SYSCLK, chSysGetRealtimeCounterX() - start); }
+#        else
+static uint32_t scheduler_read(void) { return timer_read32(); }
+
+/* Only whole milliseconds can be told apart here, and a tick may pass a
+ * moment after the start, so one tick is taken off: the elapsed time is never
+ * overestimated, and budgets under a millisecond are only enforced once a
+ * task is at least that late.
+ */
+static uint32_t scheduler_elapsed_us(uint32_t start) {
+    uint32_t ticks = TIMER_DIFF_32(timer_read32(), start);
+    return ticks ? (ticks - 1) * 1000 : 0;
+}
+#        endif
+
+typedef struct {
+    void (*task)(void);
+    const char *name;
+    uint8_t     priority;        // lower runs first
+    uint16_t    budget;          // microseconds a run should fit in
+    bool        defer_on_input;  // skipped while key events are coming in
+    uint8_t     deferred;        // runs skipped in a row
+    uint16_t    overruns;
+} scheduled_task_t;
+
+static scheduled_task_t scheduled_tasks[] = {
+#        ifdef POINTING_DEVICE_ENABLE
+    {.task = pointing_device_task, .name = "pointing", .priority = SCHEDULER_POINTING_PRIORITY, .budget = SCHEDULER_POINTING_BUDGET_US, .defer_on_input = false},
+#        endif
+#        ifdef LIGHTING_TASK
+    {.task = lighting_task, .name = "lighting", .priority = SCHEDULER_LIGHTING_PRIORITY, .budget = SCHEDULER_LIGHTING_BUDGET_US, .defer_on_input = true},
+#        endif
+#        ifdef OLED_DRIVER_ENABLE
+    {.task = display_task, .name = "oled", .priority = SCHEDULER_OLED_PRIORITY, .budget = SCHEDULER_OLED_BUDGET_US, .defer_on_input = true},
+#        endif
+};
+
+#        define SCHEDULED_TASK_COUNT (sizeof(scheduled_tasks) / sizeof(scheduled_tasks[0]))
+
+/** \brief Orders the scheduled tasks by priority
+ */
+static void scheduler_init(void) {
+    for (uint8_t i = 1; i < SCHEDULED_TASK_COUNT; i++) {
+        scheduled_task_t task = scheduled_tasks[i];
+        uint8_t          j    = i;
+        for (; j > 0 && scheduled_tasks[j - 1].priority > task.priority; j--) {
+            scheduled_tasks[j] = scheduled_tasks[j - 1];
+        }
+        scheduled_tasks[j] = task;
+    }
+}
+
+/** \brief Runs the tasks that fit in this scan
+ *
+ * Tasks run in priority order until SCHEDULER_SCAN_BUDGET_US is used up, the
+ * rest wait for the next scan. Tasks that defer on input also wait while key
+ * events are coming in. No task waits more than SCHEDULER_MAX_DEFER scans.
+ */
+static void scheduler_task(bool input_pending) {
+    uint32_t scan_start = scheduler_read();
+
+    for (uint8_t i = 0; i < SCHEDULED_TASK_COUNT; i++) {
+        scheduled_task_t *task = &scheduled_tasks[i];
+
+        bool out_of_time = scheduler_elapsed_us(scan_start) >= SCHEDULER_SCAN_BUDGET_US;
+        if ((out_of_time || (input_pending && task->defer_on_input)) && task->deferred < SCHEDULER_MAX_DEFER) {
+            task->deferred++;
+            continue;
+        }
+
+        uint32_t task_start = scheduler_read();
+        task->task();
+        uint32_t elapsed = scheduler_elapsed_us(task_start);
+        task->deferred   = 0;
+
+        if (elapsed > task->budget) {
+            if (task->overruns < UINT16_MAX) task->overruns++;
+            dprintf("scheduler: %s took %lu us, budget %u us\n", task->name, elapsed, task->budget);
+        }
+    }
+}
+
+uint16_t scheduler_get_overruns(void) {
+    uint16_t overruns = 0;
+    for (uint8_t i = 0; i < SCHEDULED_TASK_COUNT; i++) {
+        overruns += scheduled_tasks[i].overruns;
+    }
+    return overruns;
+}
+#    else
+#        define scheduler_init()
+#        define scheduler_task(input_pending)
+uint16_t scheduler_get_overruns(void) { return 0; }
+#    endif
+#endif
+
 /** \brief keyboard_init
  *
  * FIXME: needs doc
@@ -296,10 +480,17 @@ void housekeeping_task(void) {
 void keyboard_init(void) {
     timer_init();
     sync_timer_init();
+    scan_profile_init();
+#ifdef KEYBOARD_TASK_SCHEDULER
+    scheduler_init();
+#endif
     matrix_init();
 #ifdef VIA_ENABLE
     via_init();
 #endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_init();
+#endif
 #ifdef QWIIC_ENABLE
     qwiic_init();
 #endif
@@ -338,7 +529,7 @@ void keyboard_init(void) {
     dip_switch_init();
 #endif
 
-#if defined(DEBUG_MATRIX_SCAN_RATE) && defined(CONSOLE_ENABLE)
+#if (defined(DEBUG_MATRIX_SCAN_RATE) || defined(SCAN_PROFILE_ENABLE)) && defined(CONSOLE_ENABLE)
     debug_enable = true;
 #endif
 
@@ -373,19 +564,27 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
  */
 void keyboard_task(void) {
     static matrix_row_t matrix_prev[MATRIX_ROWS];
-    static uint8_t      led_status    = 0;
-    matrix_row_t        matrix_row    = 0;
-    matrix_row_t        matrix_change = 0;
-#ifdef QMK_KEYS_PER_SCAN
-    uint8_t keys_processed = 0;
-#endif
+    static uint8_t      led_status     = 0;
+    matrix_row_t        matrix_row     = 0;
+    matrix_row_t        matrix_change  = 0;
+    uint8_t             keys_processed = 0;
 #ifdef ENCODER_ENABLE
     bool encoders_changed = false;
 #endif
 
+    SCAN_PROFILE_START(keyboard_task_start);
+
+    SCAN_PROFILE_START(matrix_scan_start);
     uint8_t matrix_changed = matrix_scan();
+    SCAN_PROFILE_END(SCAN_PROFILE_MATRIX_SCAN, matrix_scan_start);
     if (matrix_changed) last_matrix_activity_trigger();
 
+    // Every change found by this scan is handed to action_exec() in a single pass,
+    // in row/column order. They were detected together, so they share a timestamp.
+    uint16_t event_time = timer_read() | 1; /* time should not be 0 */
+
+    SCAN_PROFILE_START(action_exec_start);
+
     for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
         matrix_row    = matrix_get_row(r);
         matrix_change = matrix_row ^ matrix_prev[r];
@@ -396,51 +595,42 @@ void keyboard_task(void) {
             }
 #endif
             if (debug_matrix) matrix_print();
-            matrix_row_t col_mask = 1;
-            for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
-                if (matrix_change & col_mask) {
-                    if (should_process_keypress()) {
-                        action_exec((keyevent_t){
-                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
-                        });
-                    }
-                    // record a processed key
-                    matrix_prev[r] ^= col_mask;
-
-                    switch_events(r, c, (matrix_row & col_mask));
+            // visit only the columns that changed, lowest first
+            while (matrix_change) {
+                uint8_t      c        = matrix_row_lowest_col(matrix_change);
+                matrix_row_t col_mask = MATRIX_ROW_SHIFTER << c;
+                matrix_change &= matrix_change - 1;
+
+                if (should_process_keypress()) {
+                    action_exec((keyevent_t){.key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = KEY_EVENT_TIME(r, c, event_time)});
+                }
+                // record a processed key
+                matrix_prev[r] ^= col_mask;
+
+                switch_events(r, c, (matrix_row & col_mask));
 
+                keys_processed++;
 #ifdef QMK_KEYS_PER_SCAN
-                    // only jump out if we have processed "enough" keys.
-                    if (++keys_processed >= QMK_KEYS_PER_SCAN)
+                // leave the remaining changes for the next scan if a limit was configured
+                if (keys_processed >= QMK_KEYS_PER_SCAN) goto MATRIX_LOOP_END;
 #endif
-                        // process a key per task call
-                        goto MATRIX_LOOP_END;
-                }
             }
         }
     }
-    // call with pseudo tick event when no real key event.
-#ifdef QMK_KEYS_PER_SCAN
-    // we can get here with some keys processed now.
-    if (!keys_processed)
-#endif
-        action_exec(TICK);
+    // call with pseudo tick event when no real key event, once a tapping or one shot timeout is due.
+    if (!keys_processed && (deadline_passed(DEADLINE_TAPPING) || deadline_passed(DEADLINE_ONESHOT))) action_exec(TICK);
 
+#ifdef QMK_KEYS_PER_SCAN
 MATRIX_LOOP_END:
+#endif
+    SCAN_PROFILE_END(SCAN_PROFILE_ACTION_EXEC, action_exec_start);
 
 #ifdef DEBUG_MATRIX_SCAN_RATE
     matrix_scan_perf_task();
 #endif
 
-#if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
-#endif
-
-#ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
-#endif
-#ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
+#if defined(LIGHTING_TASK) && !defined(KEYBOARD_TASK_SCHEDULER)
+    lighting_task();
 #endif
 
 #if defined(BACKLIGHT_ENABLE)
@@ -459,7 +649,9 @@ MATRIX_LOOP_END:
 #endif
 
 #ifdef OLED_DRIVER_ENABLE
-    oled_task();
+#    ifndef KEYBOARD_TASK_SCHEDULER
+    display_task();
+#    endif
 #    ifndef OLED_DISABLE_TIMEOUT
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
 #        ifdef ENCODER_ENABLE
@@ -495,7 +687,10 @@ MATRIX_LOOP_END:
     visualizer_update(default_layer_state, layer_state, visualizer_get_mods(), host_keyboard_leds());
 #endif
 
-#ifdef POINTING_DEVICE_ENABLE
+#ifdef KEYBOARD_TASK_SCHEDULER
+    // input has been handled, the rest can wait if more is coming
+    scheduler_task(matrix_changed || keys_processed);
+#elif defined(POINTING_DEVICE_ENABLE)
     pointing_device_task();
 #endif
 
@@ -518,6 +713,9 @@ MATRIX_LOOP_END:
         led_status = host_keyboard_leds();
         keyboard_set_leds(led_status);
     }
+
+    SCAN_PROFILE_END(SCAN_PROFILE_KEYBOARD_TASK, keyboard_task_start);
+    scan_profile_task();
 }
 
 /** \brief keyboard set leds
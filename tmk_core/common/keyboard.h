@@ -79,12 +79,17 @@ uint32_t last_input_activity_elapsed(void);  // Number of milliseconds since the
 
 uint32_t last_matrix_activity_time(void);     // Timestamp of the last matrix activity
 uint32_t last_matrix_activity_elapsed(void);  // Number of milliseconds since the last matrix activity
+void     last_matrix_activity_trigger(void);   // Records matrix activity now
 
 uint32_t last_encoder_activity_time(void);     // Timestamp of the last encoder activity
 uint32_t last_encoder_activity_elapsed(void);  // Number of milliseconds since the last encoder activity
 
 uint32_t get_matrix_scan_rate(void);
 
+#ifdef KEYBOARD_TASK_SCHEDULER
+uint16_t scheduler_get_overruns(void);  // Number of times a scheduled task went over its budget
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,260 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include "latency_trace.h"
+#include "timer.h"
+#include "debug.h"
+
+typedef struct {
+    keypos_t key;
+    bool     pressed;
+    uint16_t time;
+} latency_trace_pending_t;
+
+// Keys being processed, or acted for, the innermost last
+typedef struct {
+    keypos_t key;
+    bool     pressed;
+    uint8_t  source;
+} latency_trace_frame_t;
+
+// Nesting kept track of: a combo replaying a key, a macro played back by it, ...
+#define LATENCY_TRACE_DEPTH 4
+
+// oldest first
+static latency_trace_pending_t pending[LATENCY_TRACE_PENDING];
+static uint8_t                 pending_count = 0;
+
+static latency_trace_frame_t frames[LATENCY_TRACE_DEPTH];
+static uint8_t               depth = 0;
+
+// The event action_exec() is handling, if any: processing any other one means tapping held it back
+static keyevent_t current;
+
+static latency_trace_t traces[LATENCY_TRACE_SIZE];
+static uint8_t         traces_head  = 0;  // next slot to write
+static uint8_t         traces_count = 0;
+static uint32_t        traces_total = 0;
+
+// Event times are rounded up to be odd, so they can be a millisecond in the future
+static uint16_t latency_trace_elapsed(uint16_t time) {
+    uint16_t elapsed = timer_read() - time;
+    return elapsed > UINT16_MAX / 2 ? 0 : elapsed;
+}
+
+static void pending_remove(uint8_t index) {
+    pending_count--;
+    for (uint8_t i = index; i < pending_count; i++) {
+        pending[i] = pending[i + 1];
+    }
+}
+
+static void pending_expire(void) {
+    while (pending_count && latency_trace_elapsed(pending[0].time) > LATENCY_TRACE_TIMEOUT) {
+        pending_remove(0);
+    }
+}
+
+// The oldest event of the key still waiting for a report, or pending_count
+static uint8_t pending_find(keypos_t key, bool pressed) {
+    uint8_t index;
+    for (index = 0; index < pending_count; index++) {
+        if (KEYEQ(pending[index].key, key) && pending[index].pressed == pressed) break;
+    }
+    return index;
+}
+
+/** \brief Remembers a key event coming from the matrix, called for ticks as well
+ */
+void latency_trace_event(keyevent_t event) {
+    current = event;
+    if (IS_NOEVENT(event)) return;
+
+    pending_expire();
+    if (pending_count == LATENCY_TRACE_PENDING) {
+        pending_remove(0);
+    }
+    pending[pending_count++] = (latency_trace_pending_t){.key = event.key, .pressed = event.pressed, .time = event.time};
+}
+
+static void frame_push(keypos_t key, bool pressed, uint8_t source) {
+    if (depth < LATENCY_TRACE_DEPTH) {
+        frames[depth] = (latency_trace_frame_t){.key = key, .pressed = pressed, .source = source};
+    }
+    depth++;
+}
+
+static void frame_pop(void) {
+    if (depth) depth--;
+}
+
+void latency_trace_process_begin(keyevent_t *event) { frame_push(event->key, event->pressed, LATENCY_TRACE_DIRECT); }
+
+void latency_trace_process_end(void) { frame_pop(); }
+
+/** \brief Credits the reports sent until latency_trace_source_end() to a key event
+ *
+ * For features sending reports outside of the processing of the event they
+ * complete: from a timer, or while processing another key.
+ */
+void latency_trace_source_begin(keypos_t key, bool pressed, uint8_t source) { frame_push(key, pressed, source); }
+
+void latency_trace_source_end(void) { frame_pop(); }
+
+static inline const char *latency_trace_source_name(uint8_t source) {
+    switch (source) {
+        case LATENCY_TRACE_TAPPING:
+            return " (tapping)";
+        case LATENCY_TRACE_COMBO:
+            return " (combo)";
+        case LATENCY_TRACE_AUTO_SHIFT:
+            return " (auto shift)";
+        case LATENCY_TRACE_TAP_DANCE:
+            return " (tap dance)";
+        default:
+            return "";
+    }
+}
+
+/** \brief Completes the trace of the event responsible for the keyboard report just sent
+ */
+void latency_trace_report_sent(void) {
+    pending_expire();
+
+    uint8_t top   = depth < LATENCY_TRACE_DEPTH ? depth : LATENCY_TRACE_DEPTH;
+    uint8_t index = pending_count;
+    uint8_t frame;
+    /* Only the first report sent for an event counts. A key being processed
+     * that is already traced, or was never pending (a played back macro),
+     * passes it on outwards; a feature acting for a key keeps it.
+     */
+    for (frame = top; frame > 0 && index == pending_count; frame--) {
+        index = pending_find(frames[frame - 1].key, frames[frame - 1].pressed);
+        if (frames[frame - 1].source != LATENCY_TRACE_DIRECT) break;
+    }
+    if (index == pending_count) return;
+
+    // the outermost feature acting for a key is the one that decided when to send
+    uint8_t source = LATENCY_TRACE_DIRECT;
+    for (uint8_t i = 0; i < top && source == LATENCY_TRACE_DIRECT; i++) {
+        source = frames[i].source;
+    }
+    if (source == LATENCY_TRACE_DIRECT && !(KEYEQ(current.key, pending[index].key) && current.pressed == pending[index].pressed && !IS_NOEVENT(current))) {
+        source = LATENCY_TRACE_TAPPING;
+    }
+
+    latency_trace_t *trace = &traces[traces_head];
+    trace->key             = pending[index].key;
+    trace->pressed         = pending[index].pressed;
+    trace->source          = source;
+    trace->latency         = latency_trace_elapsed(pending[index].time);
+    pending_remove(index);
+
+    traces_head = (traces_head + 1) % LATENCY_TRACE_SIZE;
+    if (traces_count < LATENCY_TRACE_SIZE) traces_count++;
+    traces_total++;
+
+    dprintf("latency: %u,%u %s %u ms%s\n", trace->key.row, trace->key.col, trace->pressed ? "down" : "up", trace->latency, latency_trace_source_name(trace->source));
+}
+
+uint8_t latency_trace_count(void) { return traces_count; }
+
+const latency_trace_t *latency_trace_get(uint8_t index) {
+    if (index >= traces_count) return NULL;
+    return &traces[(traces_head + LATENCY_TRACE_SIZE - 1 - index) % LATENCY_TRACE_SIZE];
+}
+
+void latency_trace_clear(void) {
+    traces_head   = 0;
+    traces_count  = 0;
+    traces_total  = 0;
+    pending_count = 0;
+}
+
+static void latency_trace_summary(uint16_t *min, uint16_t *avg, uint16_t *max) {
+    uint32_t sum = 0;
+
+    *min = traces_count ? UINT16_MAX : 0;
+    *max = 0;
+    for (uint8_t i = 0; i < traces_count; i++) {
+        uint16_t latency = traces[i].latency;
+        if (latency < *min) *min = latency;
+        if (latency > *max) *max = latency;
+        sum += latency;
+    }
+    *avg = traces_count ? sum / traces_count : 0;
+}
+
+void latency_trace_print(void) {
+    uint16_t min, avg, max;
+
+    latency_trace_summary(&min, &avg, &max);
+    uprintf("latency: last %u of %lu, min %u avg %u max %u ms\n", traces_count, traces_total, min, avg, max);
+    for (uint8_t i = 0; i < traces_count; i++) {
+        uprintf("  %u,%u %s %u ms%s\n", latency_trace_get(i)->key.row, latency_trace_get(i)->key.col, latency_trace_get(i)->pressed ? "down" : "up", latency_trace_get(i)->latency, latency_trace_source_name(latency_trace_get(i)->source));
+    }
+}
+
+bool latency_trace_raw_hid_query(uint8_t *data, uint8_t length) {
+    if (length < 12) return false;
+
+    uint8_t selector = data[0];
+
+    switch (selector) {
+        case 0: {
+            // traces kept, traces since cleared, then min, avg and max
+            uint16_t min, avg, max;
+            latency_trace_summary(&min, &avg, &max);
+            data[1]  = traces_count;
+            data[2]  = (traces_total >> 24) & 0xFF;
+            data[3]  = (traces_total >> 16) & 0xFF;
+            data[4]  = (traces_total >> 8) & 0xFF;
+            data[5]  = traces_total & 0xFF;
+            data[6]  = min >> 8;
+            data[7]  = min & 0xFF;
+            data[8]  = avg >> 8;
+            data[9]  = avg & 0xFF;
+            data[10] = max >> 8;
+            data[11] = max & 0xFF;
+            return true;
+        }
+        case 1: {
+            // as many traces as fit, most recent first: row, col | pressed << 7, source, latency
+            uint8_t index = data[1];
+            uint8_t i     = 2;
+            while (i + 5 <= length) {
+                const latency_trace_t *trace = latency_trace_get(index++);
+                if (trace) {
+                    data[i]     = trace->key.row;
+                    data[i + 1] = trace->key.col | (trace->pressed ? 0x80 : 0);
+                    data[i + 2] = trace->source;
+                    data[i + 3] = trace->latency >> 8;
+                    data[i + 4] = trace->latency & 0xFF;
+                } else {
+                    data[i] = data[i + 1] = data[i + 2] = data[i + 3] = data[i + 4] = 0xFF;
+                }
+                i += 5;
+            }
+            return true;
+        }
+        case 2:
+            latency_trace_clear();
+            return true;
+        default:
+            return false;
+    }
+}
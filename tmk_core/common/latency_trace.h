@@ -0,0 +1,98 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Keypress to HID report latency tracing.
+ *
+ * Every key event is remembered with the time it was detected in the matrix.
+ * The first keyboard report sent because of it completes the trace, which
+ * goes into a ring buffer of the most recent ones. A report belongs to the
+ * innermost key being processed that still waits for one, even when tapping
+ * held it back. Features sending reports later on, from a timer or for an
+ * earlier key, name the key they act for with latency_trace_source_begin().
+ * Reports sent on behalf of no key are not traced.
+ */
+
+// Completed traces kept in RAM
+#ifndef LATENCY_TRACE_SIZE
+#    define LATENCY_TRACE_SIZE 32
+#endif
+
+// Events waiting for a report; the oldest is forgotten when full
+#ifndef LATENCY_TRACE_PENDING
+#    define LATENCY_TRACE_PENDING 8
+#endif
+
+// Events that got no report within this many milliseconds never will (layer keys, ...)
+#ifndef LATENCY_TRACE_TIMEOUT
+#    define LATENCY_TRACE_TIMEOUT 2000
+#endif
+
+// What sent the report, when it was not the event's own processing
+enum latency_trace_source {
+    LATENCY_TRACE_DIRECT = 0,
+    LATENCY_TRACE_TAPPING,  // a tap or hold decided after the event
+    LATENCY_TRACE_COMBO,    // a combo firing, or the keys it held back
+    LATENCY_TRACE_AUTO_SHIFT,
+    LATENCY_TRACE_TAP_DANCE,
+};
+
+typedef struct {
+    keypos_t key;
+    bool     pressed;
+    uint8_t  source;
+    uint16_t latency;  // milliseconds
+} latency_trace_t;
+
+#ifdef LATENCY_TRACE_ENABLE
+void latency_trace_event(keyevent_t event);
+void latency_trace_process_begin(keyevent_t *event);
+void latency_trace_process_end(void);
+void latency_trace_source_begin(keypos_t key, bool pressed, uint8_t source);
+void latency_trace_source_end(void);
+void latency_trace_report_sent(void);
+
+uint8_t                latency_trace_count(void);
+const latency_trace_t *latency_trace_get(uint8_t index);  // 0 is the most recent
+void                   latency_trace_clear(void);
+void                   latency_trace_print(void);
+
+/* Fills a raw HID response: data[0] selects the summary (0), a page of traces
+ * starting at index data[1] (1), or clears them (2). Returns false for an
+ * unknown selector.
+ */
+bool latency_trace_raw_hid_query(uint8_t *data, uint8_t length);
+#else
+#    define latency_trace_event(event)
+#    define latency_trace_process_begin(event)
+#    define latency_trace_process_end()
+#    define latency_trace_source_begin(key, pressed, source)
+#    define latency_trace_source_end()
+#    define latency_trace_report_sent()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
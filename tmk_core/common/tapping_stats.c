@@ -0,0 +1,169 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "tapping_stats.h"
+#include "timer.h"
+#include "debug.h"
+
+#ifdef NO_ACTION_TAPPING
+#    error "TAPPING_STATS_ENABLE needs the tapping engine, remove NO_ACTION_TAPPING"
+#endif
+
+typedef struct {
+    keypos_t key;
+    uint16_t press_time;  // while down
+    uint16_t other_time;  // first other key down since the press
+    bool     down;
+    bool     other;
+    uint8_t  histograms[TAPPING_STATS_HISTOGRAMS][TAPPING_STATS_BINS];
+} tapping_stats_key_t;
+
+static tapping_stats_key_t keys[TAPPING_STATS_KEYS];
+static uint8_t             keys_count = 0;
+static uint8_t             dropped    = 0;  // tap-hold keys not tracked for lack of room
+
+__attribute__((unused)) static const char *const histogram_names[TAPPING_STATS_HISTOGRAMS] = {"tap held", "hold held", "tap overlap", "hold overlap"};
+
+static tapping_stats_key_t *find_key(keypos_t key) {
+    for (uint8_t i = 0; i < keys_count; i++) {
+        if (KEYEQ(keys[i].key, key)) return &keys[i];
+    }
+    return NULL;
+}
+
+static void count(uint8_t *histogram, uint16_t duration) {
+    uint16_t bin = duration / TAPPING_STATS_BIN_WIDTH;
+    if (bin >= TAPPING_STATS_BINS) bin = TAPPING_STATS_BINS - 1;
+
+    if (histogram[bin] == UINT8_MAX) {
+        for (uint8_t i = 0; i < TAPPING_STATS_BINS; i++) {
+            histogram[i] /= 2;
+        }
+    }
+    histogram[bin]++;
+}
+
+/** \brief Counts a key event once the tapping engine has decided it
+ *
+ * Called by process_record(), so events come with the time they were
+ * detected and in the order they happened. The release of a tap-hold key
+ * carries the final decision: a tap count of 0 is a hold, also when a mod-tap
+ * interrupted by another key turned into one.
+ */
+void tapping_stats_record(keyrecord_t *record) {
+    keyevent_t           event = record->event;
+    tapping_stats_key_t *entry = find_key(event.key);
+
+    if (event.pressed) {
+        for (uint8_t i = 0; i < keys_count; i++) {
+            if (keys[i].down && !keys[i].other && !KEYEQ(keys[i].key, event.key)) {
+                keys[i].other      = true;
+                keys[i].other_time = event.time;
+            }
+        }
+
+        if (!entry && is_tap_key(event.key)) {
+            if (keys_count == TAPPING_STATS_KEYS) {
+                if (dropped < UINT8_MAX) dropped++;
+                return;
+            }
+            entry = &keys[keys_count++];
+            memset(entry, 0, sizeof(tapping_stats_key_t));
+            entry->key = event.key;
+        }
+        if (entry && !entry->down) {
+            entry->down       = true;
+            entry->other      = false;
+            entry->press_time = event.time;
+        }
+    } else if (entry && entry->down) {
+        bool tap    = record->tap.count > 0;
+        entry->down = false;
+        count(entry->histograms[tap ? TAPPING_STATS_TAP_HELD : TAPPING_STATS_HOLD_HELD], TIMER_DIFF_16(event.time, entry->press_time));
+        if (entry->other) {
+            count(entry->histograms[tap ? TAPPING_STATS_TAP_OVERLAP : TAPPING_STATS_HOLD_OVERLAP], TIMER_DIFF_16(event.time, entry->other_time));
+        }
+    }
+}
+
+uint8_t tapping_stats_count(void) { return keys_count; }
+
+bool tapping_stats_key(uint8_t index, keypos_t *key) {
+    if (index >= keys_count) return false;
+    *key = keys[index].key;
+    return true;
+}
+
+const uint8_t *tapping_stats_get(keypos_t key, tapping_stats_histogram_t histogram) {
+    tapping_stats_key_t *entry = find_key(key);
+    return entry && histogram < TAPPING_STATS_HISTOGRAMS ? entry->histograms[histogram] : NULL;
+}
+
+void tapping_stats_clear(void) {
+    keys_count = 0;
+    dropped    = 0;
+}
+
+void tapping_stats_print(void) {
+    uprintf("tapping: %u keys, %u not tracked, bins of %u ms\n", keys_count, dropped, TAPPING_STATS_BIN_WIDTH);
+    for (uint8_t i = 0; i < keys_count; i++) {
+        for (uint8_t h = 0; h < TAPPING_STATS_HISTOGRAMS; h++) {
+            uprintf("  %u,%u %s |", keys[i].key.row, keys[i].key.col, histogram_names[h]);
+            for (uint8_t bin = 0; bin < TAPPING_STATS_BINS; bin++) {
+                uprintf(" %u", keys[i].histograms[h][bin]);
+            }
+            uprintf("\n");
+        }
+    }
+}
+
+bool tapping_stats_raw_hid_query(uint8_t *data, uint8_t length) {
+    if (length < 6) return false;
+
+    uint8_t selector = data[0];
+    switch (selector) {
+        case 0:
+            // keys tracked, keys not tracked, bins per histogram, bin width
+            data[1] = keys_count;
+            data[2] = dropped;
+            data[3] = TAPPING_STATS_BINS;
+            data[4] = TAPPING_STATS_BIN_WIDTH >> 8;
+            data[5] = TAPPING_STATS_BIN_WIDTH & 0xFF;
+            return true;
+        case 1: {
+            // row, col, then as many bins as fit; row and col are 0xFF past the last key
+            uint8_t histogram = data[2];
+            if (data[1] >= keys_count || histogram >= TAPPING_STATS_HISTOGRAMS) {
+                memset(&data[3], 0xFF, length - 3);
+                return true;
+            }
+            tapping_stats_key_t *entry = &keys[data[1]];
+            data[3]                    = entry->key.row;
+            data[4]                    = entry->key.col;
+            for (uint8_t bin = 0; bin < TAPPING_STATS_BINS && 5 + bin < length; bin++) {
+                data[5 + bin] = entry->histograms[histogram][bin];
+            }
+            return true;
+        }
+        case 2:
+            tapping_stats_clear();
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,82 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "action.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Tap-hold tuning statistics.
+ *
+ * For every tap-hold key position, histograms of how long the key was held
+ * when it ended up as a tap and when it ended up as a hold. When another key
+ * went down while it was held, the time from that press to the release of
+ * the tap-hold key goes into the overlap histograms. Short overlaps are
+ * rolls, long ones are the tap-hold key used as a modifier or layer: the two
+ * pairs of histograms show where TAPPING_TERM sits between what was typed
+ * and whether PERMISSIVE_HOLD or IGNORE_MOD_TAP_INTERRUPT would decide better.
+ *
+ * Counters saturate by halving their whole histogram, which keeps its shape.
+ */
+
+// Tap-hold key positions tracked, the ones beyond are not counted
+#ifndef TAPPING_STATS_KEYS
+#    define TAPPING_STATS_KEYS 8
+#endif
+
+#ifndef TAPPING_STATS_BINS
+#    define TAPPING_STATS_BINS 12
+#endif
+
+// Milliseconds per bin, the last bin also counts everything longer
+#ifndef TAPPING_STATS_BIN_WIDTH
+#    define TAPPING_STATS_BIN_WIDTH 25
+#endif
+
+typedef enum {
+    TAPPING_STATS_TAP_HELD,      // press to release of a tap
+    TAPPING_STATS_HOLD_HELD,     // press to release of a hold
+    TAPPING_STATS_TAP_OVERLAP,   // another key down to release of a tap
+    TAPPING_STATS_HOLD_OVERLAP,  // another key down to release of a hold
+    TAPPING_STATS_HISTOGRAMS,
+} tapping_stats_histogram_t;
+
+#ifdef TAPPING_STATS_ENABLE
+void tapping_stats_record(keyrecord_t *record);
+
+uint8_t        tapping_stats_count(void);
+bool           tapping_stats_key(uint8_t index, keypos_t *key);
+const uint8_t *tapping_stats_get(keypos_t key, tapping_stats_histogram_t histogram);  // TAPPING_STATS_BINS counters, NULL for an untracked key
+void           tapping_stats_clear(void);
+void           tapping_stats_print(void);
+
+/* Fills a raw HID response: data[0] selects the summary (0), the histogram
+ * data[2] of the key at index data[1] (1), or clears them all (2). Returns
+ * false for an unknown selector.
+ */
+bool tapping_stats_raw_hid_query(uint8_t *data, uint8_t length);
+#else
+#    define tapping_stats_record(record)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -16,7 +16,8 @@
 
 #include "eeprom.h"
 
-#define EEPROM_SIZE 32
+// Up to the default DYNAMIC_KEYMAP_EEPROM_MAX_ADDR, past eeconfig and VIA
+#define EEPROM_SIZE 1024
 
 static uint8_t buffer[EEPROM_SIZE];
 
@@ -0,0 +1,44 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef uint8_t pin_t;
+
+/* Fake ports for the matrix tests. Pins are numbered as on AVR, port << 4 |
+ * bit, and read the values the test puts in test_gpio_ports[port].
+ */
+typedef uint8_t port_data_t;
+
+extern port_data_t test_gpio_ports[];
+
+/* Every read goes through the test, which can count them or let a line take
+ * a number of reads to rise. Most just return test_gpio_ports[port].
+ */
+port_data_t test_gpio_read_port(uint8_t port);
+
+/* Defined by the tests that drive pins */
+void setPinOutput(pin_t pin);
+void setPinInputHigh(pin_t pin);
+void writePinLow(pin_t pin);
+
+#define TEST_PIN(port, bit) ((pin_t)(((port) << 4) | (bit)))
+
+#define readPort(pin) test_gpio_read_port((pin) >> 4)
+#define readPin(pin) ((readPort(pin) & pinPortMask(pin)) != 0)
+#define samePort(pin_a, pin_b) (((pin_a) >> 4) == ((pin_b) >> 4))
+#define pinPortMask(pin) ((port_data_t)1 << ((pin)&0xF))
@@ -13,3 +13,7 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+
+#include "suspend.h"
+
+void suspend_idle(uint8_t time) {}